@@ -26,11 +26,76 @@
 #include <boost/iterator/iterator_facade.hpp>
 #include <boost/pfr.hpp>
 
+#include <algorithm>
 #include <array>
+#include <atomic>
+#include <bitset>
 #include <cassert>
+#include <cstdint>
+#include <functional>
+#include <cstring>
+#include <memory>
+#include <numeric>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <thread>
 #include <tuple>
+#include <utility>
 #include <vector>
 
+#if defined(__AVX2__) || defined(__SSE2__)
+#include <immintrin.h>
+#endif
+
+// Structures of the Arrow C Data Interface, https://arrow.apache.org/docs/format/CDataInterface.html
+// The guard is shared with Arrow headers, so both may be included.
+#ifndef ARROW_C_DATA_INTERFACE
+#define ARROW_C_DATA_INTERFACE
+
+#define ARROW_FLAG_DICTIONARY_ORDERED 1
+#define ARROW_FLAG_NULLABLE 2
+#define ARROW_FLAG_MAP_KEYS_SORTED 4
+
+extern "C" {
+
+struct ArrowSchema {
+    // Array type description
+    const char* format;
+    const char* name;
+    const char* metadata;
+    int64_t flags;
+    int64_t n_children;
+    struct ArrowSchema** children;
+    struct ArrowSchema* dictionary;
+
+    // Release callback
+    void (*release)(struct ArrowSchema*);
+    // Opaque producer-specific data
+    void* private_data;
+};
+
+struct ArrowArray {
+    // Array data description
+    int64_t length;
+    int64_t null_count;
+    int64_t offset;
+    int64_t n_buffers;
+    int64_t n_children;
+    const void** buffers;
+    struct ArrowArray** children;
+    struct ArrowArray* dictionary;
+
+    // Release callback
+    void (*release)(struct ArrowArray*);
+    // Opaque producer-specific data
+    void* private_data;
+};
+
+} // extern "C"
+
+#endif // ARROW_C_DATA_INTERFACE
+
 namespace aoaoaott {
 
 template<typename T>
@@ -39,8 +104,265 @@ class Traits
 protected:
     static_assert(!std::is_empty<T>::value, "AoAoAoTT does not support empty structures");
     static_assert(std::is_standard_layout<T>::value, "AoAoAoTT supports only standard layout structures");
+
+    static constexpr size_t field_count() noexcept { return boost::pfr::tuple_size_v<T>; }
+
+    // Sample object to compare addresses of members. It is a constant for literal
+    // structures, so members can be looked up in constant expressions.
+    template<typename U, typename = void>
+    struct SampleObject {
+        static const inline U value{};  // construct in runtime.  
+    };
+
+    template<typename U>
+    struct SampleObject<U, std::enable_if_t<(void(U{}), true)>> {
+        static constexpr U value{};
+    };
+
+    using DelayConstruct = SampleObject<T>;
+
+    // Taken from https://github.com/boostorg/pfr/issues/60 by Fuyutsubaki
+    template<typename R>
+    static constexpr size_t member_to_index(R T::* member) noexcept
+    {
+        const auto &t = DelayConstruct::value;
+        return std::apply([&](const auto&... e) {
+            size_t idx = 0;
+            for (auto b : { static_cast<const void*>(&e) ... }) {
+                if (b == &(t.*member))
+                    return idx;
+                idx += 1;
+            }
+            return field_count();
+        }, boost::pfr::structure_tie(t));
+    }
+};
+
+template<typename> struct MemberPointer;
+
+template<typename T, typename R>
+struct MemberPointer<R T::*>
+{
+    using class_type = T;
+    using type = std::remove_cv_t<R>;
+};
+
+// Type of the field pointed by the member pointer
+template<auto member>
+using MemberType = typename MemberPointer<decltype(member)>::type;
+
+template<typename U>
+struct IsStdArray : std::false_type { };
+
+template<typename U, size_t N>
+struct IsStdArray<std::array<U, N>> : std::true_type { };
+
+// Structures which may be decomposed to their fields
+template<typename U>
+struct IsNestedAggregate : std::bool_constant<std::is_class_v<U> && std::is_aggregate_v<U> && !std::is_empty_v<U> && !IsStdArray<U>::value> { };
+
+template<typename ... TT>
+struct TypeList
+{
+    static constexpr size_t size = sizeof...(TT);
+};
+
+template<typename ... Lists>
+struct ConcatTypeLists { using type = TypeList<>; };
+
+template<typename ... TT>
+struct ConcatTypeLists<TypeList<TT...>> { using type = TypeList<TT...>; };
+
+template<typename ... TT, typename ... UU, typename ... Lists>
+struct ConcatTypeLists<TypeList<TT...>, TypeList<UU...>, Lists...> : ConcatTypeLists<TypeList<TT..., UU...>, Lists...> { };
+
+template<size_t I, typename List>
+struct TypeListElement;
+
+template<size_t I, typename ... TT>
+struct TypeListElement<I, TypeList<TT...>> { using type = std::tuple_element_t<I, std::tuple<TT...>>; };
+
+// Layout policies of SoA containers. ShallowLayout splits the structure to columns of its fields,
+// DeepLayout recursively splits nested aggregates too, so each leaf field gets its own column.
+// TransposedLayout stores std::array<U, K> fields as K columns of U, one per element.
+struct ShallowLayout
+{
+    template<typename U> static constexpr bool flatten = false;
+    template<typename U> static constexpr bool transpose = false;
+};
+
+struct DeepLayout
+{
+    template<typename U> static constexpr bool flatten = IsNestedAggregate<U>::value;
+    template<typename U> static constexpr bool transpose = false;
+};
+
+struct TransposedLayout
+{
+    template<typename U> static constexpr bool flatten = false;
+    template<typename U> static constexpr bool transpose = IsStdArray<U>::value;
+};
+
+// Types of columns storing U: U itself, or its leaf fields if the layout decomposes it
+template<typename U, typename Layout, bool decompose = Layout::template flatten<U>>
+struct LeafFields { using type = TypeList<U>; };
+
+template<typename U, typename Layout>
+struct LeafFields<U, Layout, true>
+{
+    template<size_t ... N>
+    static auto expand(std::index_sequence<N...>)
+        -> typename ConcatTypeLists<typename LeafFields<std::remove_cv_t<boost::pfr::tuple_element_t<N, U>>, Layout>::type...>::type;
+
+    using type = decltype(expand(std::make_index_sequence<boost::pfr::tuple_size_v<U>>{}));
 };
 
+// Reference to the L-th leaf field of the object, which is counted from its N-th field
+template<typename Layout, size_t L, size_t N = 0, typename U>
+constexpr auto& get_leaf(U& object) noexcept
+{
+    using F = std::remove_cv_t<boost::pfr::tuple_element_t<N, std::remove_cv_t<U>>>;
+    constexpr size_t count = LeafFields<F, Layout>::type::size;
+    if constexpr (std::is_same_v<Layout, ShallowLayout>)
+        return boost::pfr::get<L>(object);
+    else if constexpr (L >= count)
+        return get_leaf<Layout, L - count, N + 1>(object);
+    else if constexpr (Layout::template flatten<F>)
+        return get_leaf<Layout, L>(boost::pfr::get<N>(object));
+    else
+        return boost::pfr::get<N>(object);
+}
+
+// Applies a chain of member pointers, e.g. (&Outer::inner, &Inner::x), to the object
+template<typename U, typename M, typename ... Ms>
+constexpr auto& follow_path(U& object, M member, Ms ... members) noexcept
+{
+    if constexpr (sizeof...(Ms) == 0)
+        return object.*member;
+    else
+        return follow_path(object.*member, members...);
+}
+
+template<typename Column, typename = void>
+struct IsContiguous : std::false_type { };
+
+template<typename Column>
+struct IsContiguous<Column, std::void_t<decltype(std::declval<const Column&>().data())>> : std::true_type { };
+
+// Columns which are split to contiguous chunks of 'chunk_size' elements
+template<typename Column, typename = void>
+struct IsChunked : std::false_type { };
+
+template<typename Column>
+struct IsChunked<Column, std::void_t<decltype(Column::chunk_size), decltype(std::declval<const Column&>().chunk(0))>> : std::true_type { };
+
+// Columns which share their storage with copies and have to be detached before writes
+template<typename Column, typename = void>
+struct IsCopyOnWrite : std::false_type { };
+
+template<typename Column>
+struct IsCopyOnWrite<Column, std::void_t<decltype(std::declval<Column&>().detach(0, 0))>> : std::true_type { };
+
+// Columns of a size fixed at compile time, i.e. of arrays
+template<typename Column>
+struct IsFixedSize : std::false_type { };
+
+template<typename U, size_t N>
+struct IsFixedSize<std::array<U, N>> : std::true_type { };
+
+// Contiguous columns which may be written through their data(), e.g. by non-temporal stores
+template<typename Column, typename = void>
+struct IsWritableContiguous : std::false_type { };
+
+template<typename Column>
+struct IsWritableContiguous<Column, std::void_t<decltype(*std::declval<Column&>().data() = *std::declval<Column&>().data())>> : std::true_type { };
+
+// Bulk writes of at least this number of bytes use non-temporal stores. They bypass caches
+// and do not read destination lines for ownership, but data written so is not cached.
+#ifndef AO_AO_AO_TT_STREAMING_THRESHOLD
+#define AO_AO_AO_TT_STREAMING_THRESHOLD (size_t{16} << 20)
+#endif
+
+inline std::atomic<size_t> streaming_threshold{AO_AO_AO_TT_STREAMING_THRESHOLD};
+
+namespace streaming {
+
+template<typename U>
+bool enabled(size_t count) noexcept
+{
+#if defined(__SSE2__)
+    return std::is_trivially_copyable_v<U> && count * sizeof(U) >= streaming_threshold.load(std::memory_order_relaxed);
+#else
+    (void)count;
+    return false;
+#endif
+}
+
+// Writes dst[i] = source(i) for i < count with non-temporal stores. Values are staged in a buffer
+// of whole 16-byte vectors, so elements of any size are supported. If 'invariant' is set,
+// the source is the same for all elements, and the buffer is filled once.
+template<bool invariant = false, typename U, typename Source>
+void generate(U* dst, size_t count, Source source) noexcept
+{
+    static_assert(std::is_trivially_copyable_v<U>, "Non-temporal stores bypass assignment operators");
+    size_t i = 0;
+#if defined(__SSE2__)
+    constexpr size_t period = 16 / std::gcd(sizeof(U), size_t{16});
+    constexpr size_t group = period * std::max<size_t>(1, 256 / (period * sizeof(U)));
+    alignas(16) unsigned char buffer[group * sizeof(U)];
+
+    // Elements of some sizes never reach the alignment, they are written by the scalar loop below
+    for (; i < count && reinterpret_cast<uintptr_t>(dst + i) % 16 != 0; ++i)
+        dst[i] = source(i);
+
+    for (bool filled = false; i + group <= count; i += group) {
+        if (!invariant || !filled) {
+            for (size_t k = 0; k < group; ++k) {
+                const U value = source(i + k);
+                std::memcpy(buffer + k * sizeof(U), &value, sizeof(U));
+            }
+            filled = true;
+        }
+        auto* out = reinterpret_cast<__m128i*>(dst + i);
+        for (size_t v = 0; v < sizeof(buffer) / 16; ++v)
+            _mm_stream_si128(out + v, _mm_load_si128(reinterpret_cast<const __m128i*>(buffer) + v));
+    }
+
+    // Non-temporal stores are weakly ordered, make them visible before the following stores
+    _mm_sfence();
+#endif
+    for (; i < count; ++i)
+        dst[i] = source(i);
+}
+
+template<typename U>
+void fill(U* dst, size_t count, const U& value) noexcept
+{
+    generate<true>(dst, count, [&](size_t) -> const U& { return value; });
+}
+
+} // namespace streaming
+
+// Temporal locality hints of software prefetches: 'none' is for data used once,
+// 'high' keeps the line in all levels of caches
+enum class Locality { none, low, moderate, high };
+
+inline void prefetch_read(const void* ptr, Locality locality = Locality::high) noexcept
+{
+#if defined(__GNUC__)
+    // Locality must be a constant expression of the builtin
+    switch (locality) {
+        case Locality::none: __builtin_prefetch(ptr, 0, 0); break;
+        case Locality::low: __builtin_prefetch(ptr, 0, 1); break;
+        case Locality::moderate: __builtin_prefetch(ptr, 0, 2); break;
+        case Locality::high: __builtin_prefetch(ptr, 0, 3); break;
+    }
+#else
+    (void)ptr;
+    (void)locality;
+#endif
+}
+
 template<typename Container, typename ContainerRef>
 class BaseFacade
 {
@@ -48,13 +370,17 @@ class BaseFacade
 public:
     constexpr BaseFacade(ContainerRef b, size_t i) : index(i), base(b) { }
 
-    auto aggregate() const noexcept { return base->aggregate(this->get_index()); }
-    operator T() const noexcept { return aggregate(); }
+    constexpr auto aggregate() const noexcept { return base->aggregate(this->get_index()); }
+    constexpr operator T() const noexcept { return aggregate(); }
 
-    template<auto fun, typename = std::enable_if_t<std::is_member_pointer_v<decltype(fun)>>>
-    constexpr const auto& get() const noexcept
+    // Nested members are reachable by paths of member pointers, e.g. get<&Outer::inner, &Inner::x>()
+    template<auto fun, auto ... path, typename = std::enable_if_t<std::is_member_pointer_v<decltype(fun)>>>
+    constexpr decltype(auto) get() const noexcept
     {
-        return this->get_base()->get_member(fun, this->get_index());
+        if constexpr (sizeof...(path) == 0)
+            return this->get_base()->get_member(fun, this->get_index());
+        else
+            return this->get_base()->template get_path<fun, path...>(this->get_index());
     }
 
     template<auto fun, typename = std::enable_if_t<std::is_member_function_pointer_v<decltype(fun)>>, typename ... Args>
@@ -64,7 +390,7 @@ public:
     }
 
     template<typename R, typename ... Args>
-    constexpr auto operator->*(R (T::* fun)(Args ...)) const noexcept
+    constexpr auto operator->*(R (T::* fun)(Args ...)) const noexcept(nothrow_access)
     {
         return this->get_base()->get_method(index, fun);
     }
@@ -75,13 +401,17 @@ public:
         return this->get_base()->get_method(index, fun);
     }
 
+    // Returns a const reference to the field, or a proxy for std::array fields split by the layout
     template<typename R>
-    constexpr const R& operator->*(R T::* field) const noexcept
+    constexpr decltype(auto) operator->*(R T::* field) const noexcept(nothrow_access)
     {
         return this->get_base()->get_member(field, this->get_index());
     }
 
 protected:
+    // Accesses through mutable facades are writes, which may throw for tracked or copy-on-write containers
+    static constexpr bool nothrow_access = std::is_const_v<std::remove_pointer_t<ContainerRef>> || Container::nothrow_writes;
+
     constexpr ContainerRef get_base() const noexcept { return base; }
     constexpr auto get_index() const noexcept { return index; }
 
@@ -89,11 +419,13 @@ protected:
     void decrement() noexcept { --index; }
     void advance(ptrdiff_t n) noexcept { index += n; }
     bool equal(const BaseFacade& rhs) const noexcept { return index == rhs.index; }
+    // Iterators, which are facades, are assigned by rebinding, so the container pointer is not const
+    void rebind(const BaseFacade& rhs) noexcept { index = rhs.index; base = rhs.base; }
     ptrdiff_t distance_to(const BaseFacade& rhs) const noexcept { return rhs.index - index; }
 
 private:
     size_t index;
-    const ContainerRef base;
+    ContainerRef base;
 };
 
 template<typename Container>
@@ -107,32 +439,305 @@ class Facade : public BaseFacade<Container, Container*>
 public:
     constexpr Facade( Container* b, size_t index) : Base(b, index) { }
 
-    template<auto fun, typename = std::enable_if_t<std::is_member_pointer_v<decltype(fun)>>>
-    constexpr auto& get() const noexcept { return this->get_base()->get_member(fun, this->get_index()); }
+    template<auto fun, auto ... path, typename = std::enable_if_t<std::is_member_pointer_v<decltype(fun)>>>
+    constexpr decltype(auto) get() const noexcept(Base::nothrow_access)
+    {
+        if constexpr (sizeof...(path) == 0)
+            return this->get_base()->get_member(fun, this->get_index());
+        else
+            return this->get_base()->template get_path<fun, path...>(this->get_index());
+    }
 
-    auto aggregate_move() const noexcept { return this->get_base()->aggregate_move(this->get_index()); }
-    operator T() const && noexcept { return aggregate_move(); }
+    auto aggregate_move() const noexcept(Base::nothrow_access) { return this->get_base()->aggregate_move(this->get_index()); }
+    operator T() const && noexcept(Base::nothrow_access) { return aggregate_move(); }
 
     using Base::operator->*;
 
+    // Assignment of facades must not silently rebind them
+    Facade(const Facade&) = default;
+    Facade& operator=(const Facade&) = delete;
+
     template<typename R>
-    constexpr R& operator->*(R T::* field) const noexcept { return this->get_base()->get_member(field, this->get_index()); }
+    constexpr decltype(auto) operator->*(R T::* field) const noexcept(Base::nothrow_access) { return this->get_base()->get_member(field, this->get_index()); }
 
-    void operator=(const T& rhs) const noexcept
+    constexpr void operator=(const T& rhs) const noexcept(Base::nothrow_access)
     {
         static_assert(std::is_copy_assignable_v<T>, "Object cannot be assigned because its copy assignment operator is implicitly deleted");
         this->get_base()->dissipate(rhs, this->get_index());
     }
 
-    void operator=(T&& rhs) const noexcept
+    constexpr void operator=(T&& rhs) const noexcept(Base::nothrow_access)
     {
         static_assert(std::is_move_assignable_v<T>, "Object cannot be assigned because its move assignment operator is implicitly deleted");
         this->get_base()->dissipate_move(std::move(rhs), this->get_index());
     }
 };
 
-template<typename T, template <typename> class Container>
-class AoSRandomAccessContainer : Traits<T>
+// Accessor to a single member of AoS storage, i.e. a column with a stride of sizeof(T)
+template<typename Storage, typename T, typename R>
+class StridedColumn
+{
+public:
+    constexpr StridedColumn(Storage& s, R T::* m) noexcept : storage(s), member(m) { }
+
+    constexpr auto& operator[](size_t index) const noexcept { return storage[index].*member; }
+    auto size() const noexcept { return storage.size(); }
+
+private:
+    Storage& storage;
+    R T::* const member;
+};
+
+// Accessor to a nested member of elements of a column
+template<typename Column, typename ... Members>
+class NestedColumn
+{
+public:
+    constexpr NestedColumn(Column& c, Members ... m) noexcept : column(c), members(m...) { }
+
+    constexpr auto& operator[](size_t index) const noexcept
+    {
+        return std::apply([&](auto ... m) -> auto& { return follow_path(column[index], m...); }, members);
+    }
+    auto size() const noexcept { return column.size(); }
+
+private:
+    Column& column;
+    const std::tuple<Members...> members;
+};
+
+// Accessor to j-th elements of std::array fields stored in a column
+template<typename Column>
+class ElementColumn
+{
+public:
+    constexpr ElementColumn(Column c, size_t j) noexcept : column(c), element(j) { }
+
+    constexpr auto& operator[](size_t index) const noexcept { return column[index][element]; }
+    auto size() const noexcept { return column.size(); }
+
+private:
+    Column column;
+    const size_t element;
+};
+
+// Column of std::array<U, K> fields, which are split to K columns of U
+template<typename R, template <typename> class Container>
+class TransposedColumn;
+
+template<typename U, size_t K, template <typename> class Container>
+class TransposedColumn<std::array<U, K>, Container>
+{
+    static_assert(K > 0, "Empty arrays cannot be transposed");
+    using Columns = std::array<Container<U>, K>;
+public:
+    // Element of the column: a view of the array with row 'index' in all K columns
+    template<typename C>
+    class Proxy
+    {
+    public:
+        constexpr Proxy(C* c, size_t i) noexcept : columns(c), index(i) { }
+        Proxy(const Proxy&) = default;
+
+        constexpr auto& operator[](size_t j) const noexcept { return (*columns)[j][index]; }
+        static constexpr size_t size() noexcept { return K; }
+
+        operator std::array<U, K>() const
+        {
+            std::array<U, K> result;
+            for (size_t j = 0; j < K; ++j)
+                result[j] = (*columns)[j][index];
+            return result;
+        }
+
+        void operator=(const std::array<U, K>& rhs) const
+        {
+            for (size_t j = 0; j < K; ++j)
+                (*columns)[j][index] = rhs[j];
+        }
+
+        void operator=(const Proxy& rhs) const
+        {
+            for (size_t j = 0; j < K; ++j)
+                (*columns)[j][index] = (*rhs.columns)[j][rhs.index];
+        }
+
+    private:
+        C* const columns;
+        const size_t index;
+    };
+
+    auto operator[](size_t index) noexcept { return Proxy<Columns>(&columns, index); }
+    auto operator[](size_t index) const noexcept { return Proxy<const Columns>(&columns, index); }
+
+    // Column of j-th elements of arrays
+    const Container<U>& column(size_t j) const noexcept { return columns[j]; }
+
+    auto size() const noexcept { return columns[0].size(); }
+    bool empty() const noexcept { return columns[0].empty(); }
+    auto capacity() const noexcept { return columns[0].capacity(); }
+
+    void resize(size_t s) { for (auto& c : columns) c.resize(s); }
+    void reserve(size_t s) { for (auto& c : columns) c.reserve(s); }
+    void shrink_to_fit() { for (auto& c : columns) c.shrink_to_fit(); }
+
+private:
+    Columns columns{};
+};
+
+// Tracking policies of containers. NoTracking is an empty base, so it costs nothing.
+struct NoTracking
+{
+    static constexpr bool enabled = false;
+    static constexpr bool logs_writes = false;
+
+protected:
+    constexpr void log_write(size_t, size_t) noexcept { }
+};
+
+// Keeps a bitmap of modified blocks of BlockSize elements per column.
+// Bits are set by mutating facade accesses (get<>(), operator->*, operator=, method<>)
+// and by modifiers of containers. Const facades and column algorithms never set them.
+// Since mutable facades return references, any access through them is treated as a write.
+// Marking may grow the bitmaps, so writes to tracked containers are not noexcept, and even
+// reads through mutable facades modify the bitmaps: tracked containers are not safe to read
+// concurrently, unless all readers use const references.
+template<size_t BlockSize = 4096>
+class DirtyTracking
+{
+    static_assert(BlockSize > 0, "Block size must be positive");
+public:
+    static constexpr bool enabled = true;
+    static constexpr bool logs_writes = false;
+    static constexpr size_t block_size = BlockSize;
+
+protected:
+    constexpr void log_write(size_t, size_t) noexcept { }
+
+    void mark_dirty(size_t column, size_t first, size_t last) const
+    {
+        if (first >= last)
+            return;
+        if (bitmaps.size() <= column)
+            bitmaps.resize(column + 1);
+        auto& bitmap = bitmaps[column];
+        const size_t first_block = first / BlockSize;
+        const size_t last_block = (last - 1) / BlockSize;
+        if (bitmap.size() <= last_block / 64)
+            bitmap.resize(last_block / 64 + 1);
+        for (size_t b = first_block; b <= last_block; ++b)
+            bitmap[b / 64] |= uint64_t{1} << (b % 64);
+    }
+
+    // Calls f(first, last) for each run of adjacent dirty blocks, clamped by 'size'
+    template<typename F>
+    void visit_dirty(size_t column, size_t size, F f) const
+    {
+        if (column >= bitmaps.size())
+            return;
+        const auto& bitmap = bitmaps[column];
+        const size_t blocks = std::min(bitmap.size() * 64, (size + BlockSize - 1) / BlockSize);
+        auto is_dirty = [&](size_t b) { return (bitmap[b / 64] >> (b % 64)) & 1; };
+        for (size_t b = 0; b < blocks;) {
+            if ((bitmap[b / 64] >> (b % 64)) == 0) {
+                b = (b / 64 + 1) * 64;
+                continue;
+            }
+            if (!is_dirty(b)) {
+                ++b;
+                continue;
+            }
+            size_t e = b + 1;
+            while (e < blocks && is_dirty(e))
+                ++e;
+            f(b * BlockSize, std::min(e * BlockSize, size));
+            b = e;
+        }
+    }
+
+    void reset_dirty(size_t column) noexcept
+    {
+        if (column < bitmaps.size())
+            bitmaps[column].clear();
+    }
+
+    void reset_dirty() noexcept { bitmaps.clear(); }
+
+private:
+    mutable std::vector<std::vector<uint64_t>> bitmaps;
+};
+
+// Tracking policy which keeps a bounded log of ranges written by bulk operations of a container:
+// fill, assign, resize, push_back, erase_if, and assignments of column expressions. Indices over
+// the container, like zone maps, read it to update only the affected blocks. Facade writes are
+// not logged. When the log is full, the oldest ranges are merged, so readers may get a superset of writes.
+class WriteLog
+{
+public:
+    static constexpr bool enabled = false;
+    static constexpr bool logs_writes = true;
+    static const constexpr size_t capacity = 4;
+
+    WriteLog() = default;
+    WriteLog(const WriteLog&) = default;
+    WriteLog(WriteLog&&) = default;
+
+    // Assigned containers are overwritten as a whole, and generations never decrease
+    WriteLog& operator=(const WriteLog& rhs) noexcept { overwrite(rhs.generation); return *this; }
+    WriteLog& operator=(WriteLog&& rhs) noexcept { overwrite(rhs.generation); return *this; }
+
+protected:
+    constexpr uint64_t logged_generation() const noexcept { return generation; }
+
+    template<typename F>
+    void visit_logged(uint64_t since, F f) const
+    {
+        for (size_t i = 0; i < count; ++i)
+            if (entries[i].generation > since)
+                f(entries[i].first, entries[i].last);
+    }
+
+    constexpr void log_write(size_t first, size_t last) noexcept
+    {
+        if (first >= last)
+            return;
+        ++generation;
+        // Adjacent and overlapping ranges, like ones of push_back loops, share an entry
+        if (count > 0 && first <= entries[count - 1].last && entries[count - 1].first <= last) {
+            auto& entry = entries[count - 1];
+            entry = Entry{ generation, std::min(entry.first, first), std::max(entry.last, last)};
+            return;
+        }
+        if (count == capacity) {
+            entries[1] = Entry{ entries[1].generation, std::min(entries[0].first, entries[1].first), std::max(entries[0].last, entries[1].last)};
+            for (size_t i = 1; i < capacity; ++i)
+                entries[i - 1] = entries[i];
+            --count;
+        }
+        entries[count++] = Entry{ generation, first, last};
+    }
+
+private:
+    struct Entry {
+        uint64_t generation = 0;
+        size_t first = 0;
+        size_t last = 0;
+    };
+
+    void overwrite(uint64_t other) noexcept
+    {
+        generation = std::max(generation, other) + 1;
+        entries[0] = Entry{ generation, 0, std::numeric_limits<size_t>::max()};
+        count = 1;
+    }
+
+    std::array<Entry, capacity> entries{};
+    size_t count = 0;
+    uint64_t generation = 0;
+};
+
+template<typename T, template <typename> class Container, typename Tracking = NoTracking>
+class AoSRandomAccessContainer : Traits<T>, protected Tracking
 {
     friend class BaseFacade<AoSRandomAccessContainer, AoSRandomAccessContainer*>;
     friend class BaseFacade<AoSRandomAccessContainer, const AoSRandomAccessContainer*>;
@@ -140,14 +745,22 @@ class AoSRandomAccessContainer : Traits<T>
 
 public:
     using value_type = T;
-    auto size() const noexcept { return storage.size(); }
-    bool empty() const noexcept { return storage.empty(); }
+
+    // Writes may allocate dirty bitmaps, so they throw if the tracking is enabled
+    static constexpr bool nothrow_writes = !Tracking::enabled;
+    static constexpr bool logs_writes = Tracking::logs_writes;
+
+    constexpr auto size() const noexcept { return storage.size(); }
+    constexpr bool empty() const noexcept { return storage.empty(); }
 
 protected:
-    T aggregate(size_t index) const noexcept { return storage[index]; }
-    T aggregate_move(size_t index) noexcept { return std::move(storage[index]); }
-    void dissipate(const T& rhs, size_t index) noexcept { storage[index] = rhs; }
-    void dissipate_move(T&& rhs, size_t index) noexcept { storage[index] = std::move(rhs); }
+    using Traits<T>::field_count;
+    using Traits<T>::member_to_index;
+
+    constexpr T aggregate(size_t index) const noexcept { return storage[index]; }
+    T aggregate_move(size_t index) noexcept(nothrow_writes) { touch(index, index + 1); return std::move(storage[index]); }
+    constexpr void dissipate(const T& rhs, size_t index) noexcept(nothrow_writes) { touch(index, index + 1); storage[index] = rhs; }
+    constexpr void dissipate_move(T&& rhs, size_t index) noexcept(nothrow_writes) { touch(index, index + 1); storage[index] = std::move(rhs); }
 
     template<auto fun, typename ... Args>
     auto call_method(size_t index, Args&& ... args) const // noexcept?
@@ -158,6 +771,7 @@ protected:
     template<auto fun, typename ... Args>
     auto call_method(size_t index, Args&& ... args) // noexcept?
     {
+        touch(index, index + 1);
         return (storage[index].*fun)(std::forward<Args>(args)...);
     }
 
@@ -180,8 +794,9 @@ protected:
     }
 
     template<typename R, typename ... Args>
-    constexpr auto get_method(size_t index, R (T::* fun)(Args ...)) noexcept
+    constexpr auto get_method(size_t index, R (T::* fun)(Args ...)) noexcept(nothrow_writes)
     {
+        touch(index, index + 1);
         auto* e = &storage[index];
         return [=](Args&& ... args) {
             return (e->*fun)(std::forward<Args>(args)...);
@@ -190,10 +805,35 @@ protected:
 
     void replicate(const T& value, size_t start, size_t end)
     {
+        touch(start, end);
+        this->log_write(start, end);
+        if constexpr (IsWritableContiguous<Container<T>>::value && std::is_trivially_copyable_v<T>) {
+            if (streaming::enabled<T>(end - start)) {
+                streaming::fill(storage.data() + start, end - start, value);
+                return;
+            }
+        }
         for (size_t i = start; i < end; ++i)
             storage[i] = value;
     }
 
+    // Copies 'count' elements of any container, which provides operator[] convertible to T
+    template<typename Source>
+    void convert(const Source& source, size_t count)
+    {
+        touch(0, count);
+        this->log_write(0, count);
+        auto element = [&](size_t i) { return static_cast<T>(source[i]); };
+        if constexpr (IsWritableContiguous<Container<T>>::value && std::is_trivially_copyable_v<T>) {
+            if (streaming::enabled<T>(count)) {
+                streaming::generate(storage.data(), count, element);
+                return;
+            }
+        }
+        for (size_t i = 0; i < count; ++i)
+            storage[i] = element(i);
+    }
+
     template<typename R>
     constexpr const R& get_member(R T::* member, size_t index) const noexcept
     {
@@ -201,36 +841,123 @@ protected:
     }
 
     template<typename R>
-    constexpr R& get_member(R T::* member, size_t index) noexcept
+    constexpr R& get_member(R T::* member, size_t index) noexcept(nothrow_writes)
     {
+        touch(member, index);
         return storage[index].*member;
     }
 
-    Container<T> storage;
+    template<auto first, auto ... path>
+    constexpr const auto& get_path(size_t index) const noexcept { return follow_path(storage[index], first, path...); }
+
+    template<auto first, auto ... path>
+    constexpr auto& get_path(size_t index) noexcept(nothrow_writes)
+    {
+        touch(first, index);
+        return follow_path(storage[index], first, path...);
+    }
+
+    template<typename R>
+    auto get_column(R T::* member) const noexcept { return StridedColumn<const Container<T>, T, R>(storage, member); }
+
+    template<auto ... path>
+    auto get_path_column() const noexcept { return NestedColumn<const Container<T>, decltype(path)...>(storage, path...); }
+
+    template<typename R>
+    auto get_element_column(R T::* member, size_t j) const noexcept { return ElementColumn(get_column(member), j); }
+
+    template<typename R>
+    auto get_column(R T::* member) noexcept { return StridedColumn<Container<T>, T, R>(storage, member); }
+
+    template<typename R>
+    auto get_mutable_column(R T::* member) noexcept { return get_column(member); }
+
+    template<typename R>
+    void prefetch_member(R T::* member, size_t index, Locality locality) const noexcept
+    {
+        prefetch_read(&(storage[index].*member), locality);
+    }
+
+    // All cache lines covered by the element
+    void prefetch_element(size_t index, Locality locality) const noexcept
+    {
+        const auto first = reinterpret_cast<uintptr_t>(&storage[index]);
+        for (uintptr_t line = first & ~uintptr_t{63}; line < first + sizeof(T); line += 64)
+            prefetch_read(reinterpret_cast<const void*>(line), locality);
+    }
+
+    // Marks the field of the element as modified if the tracking is enabled
+    template<typename R>
+    constexpr void touch(R T::* member, size_t index) const noexcept(nothrow_writes) { touch(member, index, index + 1); }
+
+    template<typename R>
+    constexpr void touch(R T::* member, size_t first, size_t last) const noexcept(nothrow_writes)
+    {
+        if constexpr (Tracking::enabled)
+            this->mark_dirty(member_to_index(member), first, last);
+    }
+
+    // Marks all fields of the range as modified if the tracking is enabled
+    constexpr void touch(size_t first, size_t last) const noexcept(nothrow_writes)
+    {
+        if constexpr (Tracking::enabled)
+            for (size_t c = 0; c < field_count(); ++c)
+                this->mark_dirty(c, first, last);
+    }
+
+    Container<T> storage{};
 };
 
-template<typename T, template <typename> class Container>
-class SoARandomAccessContainer : Traits<T>
+// Columns of SoA containers: fields of T, and fields of its nested aggregates for DeepLayout
+template<typename T, template <typename> class Container, typename Layout>
+struct SoAColumnTypes
 {
-    template<typename... TT> struct type_list {};
+    template<typename U>
+    using Column = std::conditional_t<Layout::template transpose<U>, TransposedColumn<U, Container>, Container<U>>;
 
-    template<typename U> struct loophole_type_list;
-    template<int... NN> struct loophole_type_list<std::integer_sequence<int, NN...>>
-    {
-        using type = type_list< std::remove_cv_t<boost::pfr::tuple_element_t<NN, T>>... >;
-    };
+    template<typename ... TT>
+    static constexpr std::tuple<Column<TT>...> tupilzer(TypeList<TT...>);
+
+    using Storage = decltype(tupilzer(typename LeafFields<T, Layout, true>::type{}));
+};
+
+// Const methods of elements may write their mutable fields back, so columns are mutable.
+// Fixed-size columns are not: constant arrays may be evaluated at compile time and placed
+// to read-only data, which mutable members prevent.
+template<typename T, template <typename> class Container, typename Layout, bool = IsFixedSize<Container<char>>::value>
+struct SoAColumns : SoAColumnTypes<T, Container, Layout>
+{
+    mutable typename SoAColumnTypes<T, Container, Layout>::Storage storage{};
+};
+
+template<typename T, template <typename> class Container, typename Layout>
+struct SoAColumns<T, Container, Layout, true> : SoAColumnTypes<T, Container, Layout>
+{
+    typename SoAColumnTypes<T, Container, Layout>::Storage storage{};
+};
+
+template<typename T, template <typename> class Container, typename Tracking = NoTracking, typename Layout = ShallowLayout>
+class SoARandomAccessContainer : Traits<T>, protected Tracking, protected SoAColumns<T, Container, Layout>
+{
+    using AsTypeList = typename LeafFields<T, Layout, true>::type;
 
     static const constexpr size_t tuple_size = boost::pfr::tuple_size_v<T>;
-    using AsTypeList = typename loophole_type_list<std::make_integer_sequence<int, tuple_size>>::type;
-    using Indices = std::make_index_sequence<tuple_size>;
+    static const constexpr size_t leaf_count = AsTypeList::size;
+    using Indices = std::make_index_sequence<leaf_count>;
 
-    template<typename ... TT>
-    static constexpr std::tuple<Container<TT>...> tupilzer(type_list<TT...>);
+    template<size_t L>
+    using LeafType = typename TypeListElement<L, AsTypeList>::type;
+
+    using Columns = SoAColumns<T, Container, Layout>;
+    using typename Columns::Storage;
 
-    using Storage = decltype(tupilzer(AsTypeList{}));
+    template<typename U>
+    using Column = typename Columns::template Column<U>;
+
+    static constexpr bool fixed_size = IsFixedSize<Container<char>>::value;
 
     template<typename ... TT>
-    static constexpr size_t sizeof_list(type_list<TT...>)
+    static constexpr size_t sizeof_list(TypeList<TT...>)
     {
         size_t result = 0;
         for (auto e : { sizeof(TT) ... })
@@ -239,7 +966,7 @@ class SoARandomAccessContainer : Traits<T>
     }
 
     template<typename ... TT>
-    static constexpr bool check_bool(type_list<TT...>)
+    static constexpr bool check_bool(TypeList<TT...>)
     {
         for (auto e : { std::is_same_v<TT, bool>... })
             if (e)
@@ -255,48 +982,149 @@ class SoARandomAccessContainer : Traits<T>
 
 public:
     using value_type = T;
-    auto size() const noexcept { return std::get<0>(storage).size(); }
-    bool empty() const noexcept { return std::get<0>(storage).empty(); }
+    using layout_type = Layout;
+
+    // Writes may allocate dirty bitmaps or copy shared columns, so they throw
+    // if the tracking is enabled or columns are copy-on-write
+    static constexpr bool nothrow_writes = !Tracking::enabled && !IsCopyOnWrite<std::tuple_element_t<0, Storage>>::value;
+    static constexpr bool logs_writes = Tracking::logs_writes;
+
+    constexpr auto size() const noexcept { return std::get<0>(storage).size(); }
+    constexpr bool empty() const noexcept { return std::get<0>(storage).empty(); }
 
 protected:
+    using Traits<T>::field_count;
+    using Traits<T>::member_to_index;
+
     static constexpr bool has_bool() { return check_bool(AsTypeList{}); }
 
-    T aggregate(size_t index) const noexcept { return aggregate(index, Indices{}); }
-    T aggregate_move(size_t index) const noexcept { return aggregate_move(index, Indices{}); }
+    constexpr T aggregate(size_t index) const noexcept { return aggregate(index, Indices{}); }
+    T aggregate_move(size_t index) const noexcept(nothrow_writes) { touch(index, index + 1); return aggregate_move(index, Indices{}); }
 
-    void dissipate(const T& rhs, size_t index) const noexcept { dissipate(rhs, index, Indices{}); }
-    void dissipate_move(T&& rhs, size_t index) const noexcept { dissipate_move(std::move(rhs), index, Indices{}); }
-    void replicate(const T& value, size_t start, size_t end) { replicate(value, start, end, Indices{}); }
+    constexpr void dissipate(const T& rhs, size_t index) const noexcept(nothrow_writes) { touch(index, index + 1); dissipate(rhs, index, Indices{}); }
+    constexpr void dissipate_move(T&& rhs, size_t index) const noexcept(nothrow_writes) { touch(index, index + 1); dissipate_move(std::move(rhs), index, Indices{}); }
+    void replicate(const T& value, size_t start, size_t end) { touch(start, end); this->log_write(start, end); replicate(value, start, end, Indices{}); }
+
+    // Copies 'count' elements of any container, which provides operator[] convertible to T
+    template<typename Source>
+    void convert(const Source& source, size_t count) { touch(0, count); this->log_write(0, count); convert(source, count, Indices{}); }
 
     template<typename R>
-    constexpr R& get_member(R T::* member, size_t index) const noexcept
+    constexpr decltype(auto) get_member(R T::* member, size_t index) const noexcept
     {
-        return get_container(member)[index];
+        return std::as_const(get_container(member))[index];
     }
 
-    template<auto fun, typename = std::enable_if_t<std::is_member_function_pointer_v<decltype(fun)>>, typename ... Args>
-    auto call_method(size_t index, Args&& ... args) const // noexcept?
+    template<typename R>
+    constexpr decltype(auto) get_member(R T::* member, size_t index) noexcept(nothrow_writes)
     {
-        Temp tmp(this, index);
-        return (tmp.object.*fun)(std::forward<Args>(args)...);
+        touch(member, index);
+        return get_container(member)[index];
+    }
+
+    template<auto first, auto ... path>
+    constexpr decltype(auto) get_path(size_t index) const noexcept
+    {
+        constexpr size_t depth = column_depth<first, path...>();
+        return get_path_impl<false, first, path...>(index, std::make_index_sequence<depth>{}, std::make_index_sequence<sizeof...(path) + 1 - depth>{});
+    }
+
+    template<auto first, auto ... path>
+    constexpr decltype(auto) get_path(size_t index) noexcept(nothrow_writes)
+    {
+        touch(first, index);
+        constexpr size_t depth = column_depth<first, path...>();
+        return get_path_impl<true, first, path...>(index, std::make_index_sequence<depth>{}, std::make_index_sequence<sizeof...(path) + 1 - depth>{});
+    }
+
+    template<typename R>
+    const auto& get_column(R T::* member) const noexcept { return get_container(member); }
+
+    template<typename R>
+    auto& get_mutable_column(R T::* member) noexcept { return get_container(member); }
+
+    template<size_t L>
+    const auto& get_leaf_column() const noexcept { return std::get<L>(storage); }
+
+    // Nested aggregates split by the layout are prefetched in all their leaf columns
+    template<typename R>
+    void prefetch_member(R T::* member, size_t index, Locality locality) const noexcept
+    {
+        if constexpr (Layout::template flatten<R>)
+            prefetch_subobject(member, index, locality, Indices{});
+        else
+            prefetch_leaf<R>(get_container(member), index, locality);
+    }
+
+    void prefetch_element(size_t index, Locality locality) const noexcept { prefetch_element(index, locality, Indices{}); }
+
+    // The leaf column itself if the path ends at a leaf, or an accessor of the nested member otherwise
+    template<auto first, auto ... path>
+    decltype(auto) get_path_column() const noexcept
+    {
+        constexpr size_t depth = column_depth<first, path...>();
+        return get_path_column(std::make_tuple(first, path...), std::make_index_sequence<depth>{}, std::make_index_sequence<sizeof...(path) + 1 - depth>{});
+    }
+
+    // Contiguous column for std::array fields split by the layout, an accessor otherwise
+    template<typename R>
+    decltype(auto) get_element_column(R T::* member, size_t j) const noexcept
+    {
+        if constexpr (Layout::template transpose<R>)
+            return get_container(member).column(j);
+        else
+            return ElementColumn<const Column<R>&>(get_container(member), j);
+    }
+
+    template<auto fun, typename = std::enable_if_t<std::is_member_function_pointer_v<decltype(fun)>>, typename ... Args>
+    auto call_method(size_t index, Args&& ... args) const // noexcept?
+    {
+        if constexpr (fixed_size) {
+            const T object = aggregate(index);
+            return (object.*fun)(std::forward<Args>(args)...);
+        }
+        else
+            return invoke<fun>(index, std::forward<Args>(args)...);
+    }
+
+    template<auto fun, typename = std::enable_if_t<std::is_member_function_pointer_v<decltype(fun)>>, typename ... Args>
+    auto call_method(size_t index, Args&& ... args) // noexcept?
+    {
+        touch(index, index + 1);
+        return invoke<fun>(index, std::forward<Args>(args)...);
     }
 
     template<typename R, typename ... Args>
     constexpr auto get_method(size_t index, R (T::* fun)(Args ...)) const noexcept
     {
-        return [=](Args&& ... args) {
-            Temp tmp(this, index);
-            return (tmp.object.*fun)(std::forward<Args>(args)...);
-        };
+        static_assert(!fixed_size, "Non-const methods cannot be called for elements of const arrays");
+        return bind_method<Args...>(index, fun);
+    }
+
+    template<typename R, typename ... Args>
+    constexpr auto get_method(size_t index, R (T::* fun)(Args ...)) noexcept(nothrow_writes)
+    {
+        touch(index, index + 1);
+        return bind_method<Args...>(index, fun);
     }
 
     template<typename R, typename ... Args>
     constexpr auto get_method(size_t index, R (T::* fun)(Args ...) const) const noexcept
     {
-        return [=](Args&& ... args) {
-            Temp tmp(this, index);
-            return (tmp.object.*fun)(std::forward<Args>(args)...);
-        };
+        if constexpr (fixed_size) {
+            return [=](Args&& ... args) {
+                const T object = aggregate(index);
+                return (object.*fun)(std::forward<Args>(args)...);
+            };
+        }
+        else
+            return bind_method<Args...>(index, fun);
+    }
+
+    template<typename R, typename ... Args>
+    constexpr auto get_method(size_t index, R (T::* fun)(Args ...) const) noexcept
+    {
+        return bind_method<Args...>(index, fun);
     }
 
     // In AoS container, you can do this:
@@ -317,43 +1145,95 @@ protected:
     //     storage[3].method<HastMutable::update_x>();
     // }
     //
-    // Thus, we must keep 'storage' const-qualified while mutating.
-    // The simplest point to do it is here:
-    //
-    mutable Storage storage;
+    // Thus, we must mutate 'storage' while it is const-qualified, so columns are
+    // mutable, see SoAColumns. Fixed-size columns are not: methods of elements of
+    // const arrays are called on temporaries which are not written back, so writes
+    // to mutable fields are lost there, and columns() writes only to arrays which
+    // are not const.
+    using Columns::storage;
+
+    constexpr Storage& columns() const noexcept { return const_cast<Storage&>(storage); }
+
+    // Marks the field of the element as modified if the tracking is enabled,
+    // and detaches it from the copies if columns are copy-on-write
+    template<typename R>
+    constexpr void touch(R T::* member, size_t index) const noexcept(nothrow_writes) { touch(member, index, index + 1); }
+
+    template<typename R>
+    constexpr void touch(R T::* member, size_t first, size_t last) const noexcept(nothrow_writes)
+    {
+        if constexpr (copy_on_write)
+            get_container(member).detach(first, last);
+        if constexpr (Tracking::enabled)
+            this->mark_dirty(member_to_index(member), first, last);
+    }
+
+    // Marks all fields of the range as modified if the tracking is enabled
+    constexpr void touch(size_t first, size_t last) const noexcept(nothrow_writes)
+    {
+        detach(first, last);
+        if constexpr (Tracking::enabled)
+            for (size_t c = 0; c < tuple_size; ++c)
+                this->mark_dirty(c, first, last);
+    }
+
+    constexpr void detach(size_t first, size_t last) const noexcept(nothrow_writes)
+    {
+        if constexpr (copy_on_write)
+            std::apply([=](auto& ... column){ (..., column.detach(first, last)); }, columns());
+    }
 
 private:
+    static constexpr bool copy_on_write = IsCopyOnWrite<std::tuple_element_t<0, Storage>>::value;
+
+    template<auto fun, typename ... Args>
+    auto invoke(size_t index, Args&& ... args) const
+    {
+        Temp tmp(this, index);
+        return (tmp.object.*fun)(std::forward<Args>(args)...);
+    }
+
+    template<typename ... Args, typename F>
+    constexpr auto bind_method(size_t index, F fun) const noexcept
+    {
+        return [=](Args&& ... args) {
+            Temp tmp(this, index);
+            return (tmp.object.*fun)(std::forward<Args>(args)...);
+        };
+    }
+
+    // Writes back without marking: mutable facades mark the element before the call
     class Temp
     {
         public:
             T object;
-            Temp(const SoARandomAccessContainer* base, size_t index) : object(base->aggregate(index)), base(base), index(index) { }
-            ~Temp() { base->dissipate(std::move(object), index); }
+            Temp(const SoARandomAccessContainer* base, size_t index) : object(base->aggregate(index)), base(base), index(index) { base->detach(index, index + 1); }
+            ~Temp() { base->dissipate_move(std::move(object), index, Indices{}); }
         private:
             const SoARandomAccessContainer* const base;
             size_t index;
     };
 
     template<size_t ... N>
-    void dissipate(const T& src, size_t index, std::index_sequence<N...>)
+    constexpr void dissipate(const T& src, size_t index, std::index_sequence<N...>)
         const noexcept(noexcept(std::is_nothrow_copy_assignable_v<T>))
     {
-        std::tie(std::get<N>(storage)[index]...) = boost::pfr::structure_tie(src);
+        ((void)(std::get<N>(columns())[index] = get_leaf<Layout, N>(src)), ...);
     }
 
     template<size_t ... N>
-    void dissipate_move(T&& src, size_t index, std::index_sequence<N...>)
+    constexpr void dissipate_move(T&& src, size_t index, std::index_sequence<N...>)
         const noexcept(noexcept(std::is_nothrow_move_assignable_v<T>))
     {
-        ((void)(std::get<N>(storage)[index] = std::move(boost::pfr::get<N>(src))), ...);
+        ((void)(std::get<N>(columns())[index] = std::move(get_leaf<Layout, N>(src))), ...);
     }
 
     template<size_t ... N>
-    T aggregate(size_t index, std::index_sequence<N...>)
+    constexpr T aggregate(size_t index, std::index_sequence<N...>)
         const noexcept(noexcept(std::is_nothrow_copy_assignable_v<T>))
     {
         T result{};
-        boost::pfr::structure_tie(result) = std::tie(std::get<N>(storage)[index]...);
+        ((void)(get_leaf<Layout, N>(result) = std::get<N>(storage)[index]), ...);
         return result;
     }
 
@@ -362,7 +1242,7 @@ private:
         const noexcept(noexcept(std::is_nothrow_move_assignable_v<T>))
     {
         T result{};
-        ((void)(boost::pfr::get<N>(result) = std::move(std::get<N>(storage)[index])), ...);
+        ((void)(get_leaf<Layout, N>(result) = std::move(std::get<N>(columns())[index])), ...);
         return result;
     }
 
@@ -377,228 +1257,4485 @@ private:
     template<size_t N>
     void replicate_member(const T& src, size_t start, size_t end)
     {
-        const auto& value = boost::pfr::get<N>(src);
+        const auto& value = get_leaf<Layout, N>(src);
+        auto& column = std::get<N>(storage);
+        if constexpr (IsWritableContiguous<Column<LeafType<N>>>::value && std::is_trivially_copyable_v<LeafType<N>>) {
+            if (streaming::enabled<LeafType<N>>(end - start)) {
+                streaming::fill(column.data() + start, end - start, value);
+                return;
+            }
+        }
         for (size_t i = start; i < end; ++i)
-            std::get<N>(storage)[i] = value;
+            column[i] = value;
+    }
+
+    // Elements are converted by chunks, which are scattered to the columns
+    template<typename Source, size_t ... N>
+    void convert(const Source& source, size_t count, std::index_sequence<N...>)
+    {
+        constexpr size_t chunk_size = 256;
+        std::vector<T> chunk(std::min(count, chunk_size));
+        for (size_t first = 0; first < count; first += chunk_size) {
+            const size_t size = std::min(count - first, chunk_size);
+            for (size_t k = 0; k < size; ++k)
+                chunk[k] = static_cast<T>(source[first + k]);
+            ((void)scatter_member<N>(chunk, first, size, count), ...);
+        }
+    }
+
+    template<size_t N>
+    void scatter_member(const std::vector<T>& chunk, size_t first, size_t size, size_t count)
+    {
+        auto& column = std::get<N>(storage);
+        if constexpr (IsWritableContiguous<Column<LeafType<N>>>::value && std::is_trivially_copyable_v<LeafType<N>>) {
+            if (streaming::enabled<LeafType<N>>(count)) {
+                streaming::generate(column.data() + first, size, [&](size_t k) { return get_leaf<Layout, N>(chunk[k]); });
+                return;
+            }
+        }
+        for (size_t k = 0; k < size; ++k)
+            column[first + k] = get_leaf<Layout, N>(chunk[k]);
     }
 
     template<typename R>
-    auto& get_container(R T::* member) const noexcept
+    static void prefetch_leaf(const Column<R>& column, size_t index, Locality locality) noexcept
     {
-        return *get_container_impl<tuple_size>(member);
+        if constexpr (Layout::template transpose<R>) {
+            for (size_t j = 0; j < std::tuple_size_v<R>; ++j)
+                prefetch_slot(column.column(j), index, locality);
+        } else {
+            prefetch_slot(column, index, locality);
+        }
     }
 
-    template<size_t I, typename R>
-    constexpr Container<std::remove_cv_t<R>>* get_container_impl(R T::* member) const noexcept
+    // Elements of std::vector<bool> have no addresses, so they are not prefetched
+    template<typename C>
+    static void prefetch_slot(const C& column, size_t index, Locality locality) noexcept
     {
-        (void)member;
-        if constexpr (I == 0)
+        if constexpr (std::is_lvalue_reference_v<decltype(column[index])>)
+            prefetch_read(&column[index], locality);
+    }
+
+    template<size_t ... L>
+    void prefetch_element(size_t index, Locality locality, std::index_sequence<L...>) const noexcept
+    {
+        ((void)prefetch_leaf<LeafType<L>>(std::get<L>(storage), index, locality), ...);
+    }
+
+    template<typename R, size_t ... L>
+    void prefetch_subobject(R T::* member, size_t index, Locality locality, std::index_sequence<L...>) const noexcept
+    {
+        const auto& object = Traits<T>::DelayConstruct::value;
+        const auto first = reinterpret_cast<uintptr_t>(&(object.*member));
+        auto inside = [=](const auto& leaf) {
+            const auto address = reinterpret_cast<uintptr_t>(&leaf);
+            return address >= first && address < first + sizeof(R);
+        };
+        ((void)(inside(get_leaf<Layout, L>(object)) && (prefetch_leaf<LeafType<L>>(std::get<L>(storage), index, locality), true)), ...);
+    }
+
+    // Column of the leaf field addressed by the path of member pointers
+    template<typename ... Members>
+    constexpr auto& get_container(Members ... path) const noexcept
+    {
+        using R = typename MemberPointer<std::tuple_element_t<sizeof...(Members) - 1, std::tuple<Members...>>>::type;
+        static_assert(!Layout::template flatten<R>, "Nested aggregates of deep SoA containers are split, access their fields by paths");
+        return *get_container_impl<leaf_count, R>(path...);
+    }
+
+    template<size_t L, typename R, typename ... Members>
+    constexpr Column<R>* get_container_impl(Members ... path) const noexcept
+    {
+        if constexpr (L == 0)
             return nullptr;
-        else if constexpr(!std::is_same_v<std::remove_cv_t<boost::pfr::tuple_element_t<I - 1, T>>, std::remove_cv_t<R>>)
-            return get_container_impl<I - 1>(member);
-        else if (member_to_index(member) == I - 1)
-            return &std::get<I - 1>(storage);
+        else if constexpr(!std::is_same_v<LeafType<L - 1>, R>)
+            return get_container_impl<L - 1, R>(path...);
+        else if (static_cast<const void*>(&get_leaf<Layout, L - 1>(Traits<T>::DelayConstruct::value)) == &follow_path(Traits<T>::DelayConstruct::value, path...))
+            return &std::get<L - 1>(columns());
         else
-            return get_container_impl<I - 1>(member);
+            return get_container_impl<L - 1, R>(path...);
     }
 
-    struct DelayConstruct {
-        static const inline T value{};  // construct in runtime.  
-    };
+    // Number of members in the path which address a column, the rest address subobjects of its elements
+    template<auto ... path>
+    static constexpr size_t column_depth() noexcept
+    {
+        size_t depth = 0;
+        bool leaf = false;
+        ((void)(leaf || (++depth, leaf = !Layout::template flatten<MemberType<path>>)), ...);
+        return depth;
+    }
 
-    // Taken from https://github.com/boostorg/pfr/issues/60 by Fuyutsubaki
-    template<typename R>
-    constexpr size_t member_to_index(R T::* member) const noexcept
+    template<bool is_mutable, auto ... path, size_t ... H, size_t ... K>
+    constexpr decltype(auto) get_path_impl(size_t index, std::index_sequence<H...>, std::index_sequence<K...>) const noexcept
     {
-        const auto &t = DelayConstruct::value;
-        return std::apply([&](const auto&... e) {
-            size_t idx = 0;
-            for (auto b : { static_cast<const void*>(&e) ... }) {
-                if (b == &(t.*member))
-                    return idx;
-                idx += 1;
-            }
-            return tuple_size;
-        }, boost::pfr::structure_tie(t));
+        constexpr auto members = std::make_tuple(path...);
+        auto& column = get_container(std::get<H>(members)...);
+        decltype(auto) element = [&]() -> decltype(auto) {
+            if constexpr (is_mutable)
+                return column[index];
+            else
+                return std::as_const(column)[index];
+        }();
+        if constexpr (sizeof...(K) == 0)
+            return element;
+        else
+            return follow_path(element, std::get<sizeof...(H) + K>(members)...);
+    }
+
+    template<typename Members, size_t ... H, size_t ... K>
+    decltype(auto) get_path_column(const Members& members, std::index_sequence<H...>, std::index_sequence<K...>) const noexcept
+    {
+        const auto& column = get_container(std::get<H>(members)...);
+        if constexpr (sizeof...(K) == 0)
+            return column;
+        else
+            return NestedColumn<std::remove_reference_t<decltype(column)>, std::tuple_element_t<sizeof...(H) + K, Members>...>(column, std::get<sizeof...(H) + K>(members)...);
     }
 };
 
-template<typename BaseContainer>
-class RandomAccessContainer : public BaseContainer
+// Default accumulator of sums, so long columns do not wrap around: integers are widened
+// to 64 bits, and floating-point numbers to double
+template<typename R>
+using SumType = std::conditional_t<std::is_integral_v<R> && !std::is_same_v<R, bool>,
+    std::conditional_t<std::is_signed_v<R>, int64_t, uint64_t>,
+    std::conditional_t<std::is_floating_point_v<R> && sizeof(R) < sizeof(double), double, R>>;
+
+// Column scan kernels. Generic versions work with any indexable column (pointers for
+// contiguous SoA columns, strided accessors for AoS), explicit SIMD versions are
+// selected at compile time for contiguous columns of int32_t and float.
+namespace kernels {
+
+namespace scalar {
+
+template<typename Column, typename R>
+size_t find(const Column& column, size_t size, const R& value)
 {
-public:
-    using size_type = size_t;
-    using difference_type = ptrdiff_t;
-    using reference = Facade<BaseContainer>;
-    using const_reference = ConstFacade<BaseContainer>;
+    for (size_t i = 0; i < size; ++i)
+        if (column[i] == value)
+            return i;
+    return size;
+}
 
-    constexpr auto operator[](size_t index) noexcept { return reference{ this, index}; }
-    constexpr auto operator[](size_t index) const noexcept { return const_reference{ this, index}; }
+template<typename Column, typename R>
+size_t count(const Column& column, size_t size, const R& value)
+{
+    size_t result = 0;
+    for (size_t i = 0; i < size; ++i)
+        result += column[i] == value ? 1 : 0;
+    return result;
+}
 
-    auto at(size_t index) { check_index(index); return operator[](index); }
-    auto at(size_t index) const { check_index(index); return operator[](index); }
+template<typename R>
+bool unordered(const R& value) noexcept
+{
+    if constexpr (std::is_floating_point_v<R>)
+        return value != value;
+    else
+        return false;
+}
 
-    class const_iterator : const_reference,
-        public boost::iterator_facade<const_iterator, const_reference const, std::random_access_iterator_tag, const const_reference&>
-    {
-        friend class RandomAccessContainer;
-        friend class boost::iterator_core_access;
+// NaNs are ignored, unless all values are NaN. The result starts from the first ordered value,
+// and comparisons with NaNs are false, so std::min and std::max keep the result.
+template<typename Column>
+auto minmax(const Column& column, size_t size)
+{
+    using R = std::remove_cv_t<std::remove_reference_t<decltype(column[0])>>;
+    assert(size > 0);
+    size_t first = 0;
+    while (first + 1 < size && unordered<R>(column[first]))
+        ++first;
+    std::pair<R, R> result(column[first], column[first]);
+    for (size_t i = first + 1; i < size; ++i) {
+        result.first = std::min<R>(result.first, column[i]);
+        result.second = std::max<R>(result.second, column[i]);
+    }
+    return result;
+}
 
-        const_iterator(const BaseContainer* base, size_t index) : const_reference(base, index) { }
+// Merges minimums and maximums of two parts, either of which may be all NaNs
+template<typename R>
+void merge_minmax(std::pair<R, R>& result, const std::pair<R, R>& part) noexcept
+{
+    if (unordered(result.first)) {
+        result = part;
+    }
+    else if (!unordered(part.first)) {
+        result.first = std::min(result.first, part.first);
+        result.second = std::max(result.second, part.second);
+    }
+}
 
-        const auto& dereference() const noexcept { return *this; }
-    };
+template<typename Column, typename U>
+U sum(const Column& column, size_t size, U init)
+{
+    for (size_t i = 0; i < size; ++i)
+        init += column[i];
+    return init;
+}
 
-    class iterator : reference,
-        public boost::iterator_facade<iterator, reference, std::random_access_iterator_tag, const reference&>
-    {
-        friend class RandomAccessContainer;
-        friend class boost::iterator_core_access;
+// Branchless left-pack of elements [first, size), whose mask is 0, to the position 'result' < first.
+// Destination is strictly behind the source, so there are no self-moves.
+template<typename Column>
+size_t compact(Column column, const char* mask, size_t result, size_t first, size_t size)
+{
+    for (size_t i = first; i < size; ++i) {
+        column[result] = std::move(column[i]);
+        result += 1 - mask[i];
+    }
+    return result;
+}
 
-        iterator(BaseContainer* base, size_t index) : reference(base, index) { }
+} // namespace scalar
 
-        const auto& dereference() const noexcept { return *this; }
-    };
+template<typename Column, typename R>
+size_t find(const Column& column, size_t size, const R& value) { return scalar::find(column, size, value); }
 
-    auto cbegin() const noexcept { return const_iterator{ this, 0}; }
-    auto cend() const noexcept { return const_iterator{ this, this->size()}; }
-    auto begin() const noexcept { return cbegin(); }
-    auto end() const noexcept { return cend(); }
-    auto begin() noexcept { return iterator{ this, 0}; }
-    auto end() noexcept { return iterator{ this, this->size()}; }
+template<typename Column, typename R>
+size_t count(const Column& column, size_t size, const R& value) { return scalar::count(column, size, value); }
 
-    using reverse_iterator = std::reverse_iterator<iterator>;
-    using const_reverse_iterator = std::reverse_iterator<const_iterator>;
+template<typename Column>
+auto minmax(const Column& column, size_t size) { return scalar::minmax(column, size); }
 
-    auto crbegin() const noexcept { return const_reverse_iterator(cend()); }
-    auto crend() const noexcept { return const_reverse_iterator(cbegin()); }
-    auto rbegin() const noexcept { return crbegin(); }
-    auto rend() const noexcept { return crend(); }
-    auto rbegin() noexcept { return reverse_iterator(cend()); }
-    auto rend() noexcept { return reverse_iterator(begin()); } 
+template<typename Column, typename U>
+U sum(const Column& column, size_t size, U init) { return scalar::sum(column, size, init); }
 
-    auto front() const { return *begin(); }
-    auto front() { return *begin(); }
+template<typename Column>
+size_t compact(Column column, const char* mask, size_t result, size_t first, size_t size) { return scalar::compact(column, mask, result, first, size); }
 
-    auto back() const { auto tmp = end(); --tmp; return *tmp; }
-    auto back() { auto tmp = end(); --tmp; return *tmp; }
+#if defined(__AVX2__) || defined(__SSE2__)
 
-private:
-    void check_index(size_t index) const
-    {
-        if (index >= this->size())
-            throw std::out_of_range("SoA container is out of range");
-    }
-};
+#if defined(__AVX2__)
 
-template<typename T, size_t N, typename Base>
-class BaseArray : public Base
+struct Int32Lanes
 {
-public:
-    BaseArray() = default;
-    void fill(const T& value) { this->replicate( value, 0, N); }
+    using Scalar = int32_t;
+    using Vector = __m256i;
+    static const constexpr size_t width = 8;
+    static Vector load(const Scalar* ptr) noexcept { return _mm256_loadu_si256(reinterpret_cast<const Vector*>(ptr)); }
+    static void store(Scalar* ptr, Vector v) noexcept { _mm256_storeu_si256(reinterpret_cast<Vector*>(ptr), v); }
+    static Vector broadcast(Scalar value) noexcept { return _mm256_set1_epi32(value); }
+    static Vector zero() noexcept { return _mm256_setzero_si256(); }
+    static int equal(Vector a, Vector b) noexcept { return _mm256_movemask_ps(_mm256_castsi256_ps(_mm256_cmpeq_epi32(a, b))); }
+    static Vector min(Vector a, Vector b) noexcept { return _mm256_min_epi32(a, b); }
+    static Vector max(Vector a, Vector b) noexcept { return _mm256_max_epi32(a, b); }
+    static Vector add(Vector a, Vector b) noexcept { return _mm256_add_epi32(a, b); }
+
+    // Halves of the vector sign-extended to 64 bits
+    using Wide = int64_t;
+    using WideVector = __m256i;
+    static WideVector wide_zero() noexcept { return _mm256_setzero_si256(); }
+    static WideVector widen_low(Vector v) noexcept { return _mm256_cvtepi32_epi64(_mm256_castsi256_si128(v)); }
+    static WideVector widen_high(Vector v) noexcept { return _mm256_cvtepi32_epi64(_mm256_extracti128_si256(v, 1)); }
+    static WideVector add_wide(WideVector a, WideVector b) noexcept { return _mm256_add_epi64(a, b); }
+    static void store_wide(Wide* ptr, WideVector v) noexcept { _mm256_storeu_si256(reinterpret_cast<WideVector*>(ptr), v); }
 };
 
-template<size_t N>
-struct ArrayBinder
+struct FloatLanes
 {
-    template<typename T> using type = std::array<T, N>;
-};
+    using Scalar = float;
+    using Vector = __m256;
+    static const constexpr size_t width = 8;
+    static Vector load(const Scalar* ptr) noexcept { return _mm256_loadu_ps(ptr); }
+    static void store(Scalar* ptr, Vector v) noexcept { _mm256_storeu_ps(ptr, v); }
+    static Vector broadcast(Scalar value) noexcept { return _mm256_set1_ps(value); }
+    static Vector zero() noexcept { return _mm256_setzero_ps(); }
+    static int equal(Vector a, Vector b) noexcept { return _mm256_movemask_ps(_mm256_cmp_ps(a, b, _CMP_EQ_OQ)); }
+    // Like the scalar kernels, NaNs are ignored: min_ps returns its second operand if either is NaN
+    static Vector min(Vector a, Vector b) noexcept { return _mm256_blendv_ps(_mm256_min_ps(b, a), b, _mm256_cmp_ps(a, a, _CMP_UNORD_Q)); }
+    static Vector max(Vector a, Vector b) noexcept { return _mm256_blendv_ps(_mm256_max_ps(b, a), b, _mm256_cmp_ps(a, a, _CMP_UNORD_Q)); }
+    static Vector add(Vector a, Vector b) noexcept { return _mm256_add_ps(a, b); }
 
-template<typename T, size_t N>
-using AoSArray = BaseArray<T, N, RandomAccessContainer<AoSRandomAccessContainer<T, ArrayBinder<N>::template type>>>;
+    using Wide = double;
+    using WideVector = __m256d;
+    static WideVector wide_zero() noexcept { return _mm256_setzero_pd(); }
+    static WideVector widen_low(Vector v) noexcept { return _mm256_cvtps_pd(_mm256_castps256_ps128(v)); }
+    static WideVector widen_high(Vector v) noexcept { return _mm256_cvtps_pd(_mm256_extractf128_ps(v, 1)); }
+    static WideVector add_wide(WideVector a, WideVector b) noexcept { return _mm256_add_pd(a, b); }
+    static void store_wide(Wide* ptr, WideVector v) noexcept { _mm256_storeu_pd(ptr, v); }
+};
 
-template<typename T, size_t N>
-using SoAArray = BaseArray<T, N, RandomAccessContainer<SoARandomAccessContainer<T, ArrayBinder<N>::template type>>>;
+#else
 
-template<template <typename> typename Allocator>
-struct VectorBinder
+struct Int32Lanes
 {
-    template<typename T> using type = std::vector<T, Allocator<T>>;
+    using Scalar = int32_t;
+    using Vector = __m128i;
+    static const constexpr size_t width = 4;
+    static Vector load(const Scalar* ptr) noexcept { return _mm_loadu_si128(reinterpret_cast<const Vector*>(ptr)); }
+    static void store(Scalar* ptr, Vector v) noexcept { _mm_storeu_si128(reinterpret_cast<Vector*>(ptr), v); }
+    static Vector broadcast(Scalar value) noexcept { return _mm_set1_epi32(value); }
+    static Vector zero() noexcept { return _mm_setzero_si128(); }
+    static int equal(Vector a, Vector b) noexcept { return _mm_movemask_ps(_mm_castsi128_ps(_mm_cmpeq_epi32(a, b))); }
+    // SSE2 has no signed 32-bit min and max, so blend by comparison
+    static Vector min(Vector a, Vector b) noexcept { return blend(_mm_cmpgt_epi32(a, b), b, a); }
+    static Vector max(Vector a, Vector b) noexcept { return blend(_mm_cmpgt_epi32(a, b), a, b); }
+    static Vector add(Vector a, Vector b) noexcept { return _mm_add_epi32(a, b); }
+
+    // Halves of the vector sign-extended to 64 bits by interleaving with their signs
+    using Wide = int64_t;
+    using WideVector = __m128i;
+    static WideVector wide_zero() noexcept { return _mm_setzero_si128(); }
+    static WideVector widen_low(Vector v) noexcept { return _mm_unpacklo_epi32(v, _mm_srai_epi32(v, 31)); }
+    static WideVector widen_high(Vector v) noexcept { return _mm_unpackhi_epi32(v, _mm_srai_epi32(v, 31)); }
+    static WideVector add_wide(WideVector a, WideVector b) noexcept { return _mm_add_epi64(a, b); }
+    static void store_wide(Wide* ptr, WideVector v) noexcept { _mm_storeu_si128(reinterpret_cast<WideVector*>(ptr), v); }
+private:
+    static Vector blend(Vector mask, Vector a, Vector b) noexcept { return _mm_or_si128(_mm_and_si128(mask, a), _mm_andnot_si128(mask, b)); }
 };
 
-template<typename T, template <typename> typename Allocator = std::allocator>
-class AoSVector : public RandomAccessContainer<AoSRandomAccessContainer<T, VectorBinder<Allocator>::template type>>
+struct FloatLanes
 {
-public:
-    AoSVector() { }
-    explicit AoSVector(size_t size) { resize(size); }
-    AoSVector(size_t size, const T& value) { resize(size, value); }
+    using Scalar = float;
+    using Vector = __m128;
+    static const constexpr size_t width = 4;
+    static Vector load(const Scalar* ptr) noexcept { return _mm_loadu_ps(ptr); }
+    static void store(Scalar* ptr, Vector v) noexcept { _mm_storeu_ps(ptr, v); }
+    static Vector broadcast(Scalar value) noexcept { return _mm_set1_ps(value); }
+    static Vector zero() noexcept { return _mm_setzero_ps(); }
+    static int equal(Vector a, Vector b) noexcept { return _mm_movemask_ps(_mm_cmpeq_ps(a, b)); }
+    // Like the scalar kernels, NaNs are ignored: min_ps returns its second operand if either is NaN
+    static Vector min(Vector a, Vector b) noexcept { return blend(_mm_cmpunord_ps(a, a), b, _mm_min_ps(b, a)); }
+    static Vector max(Vector a, Vector b) noexcept { return blend(_mm_cmpunord_ps(a, a), b, _mm_max_ps(b, a)); }
+    static Vector add(Vector a, Vector b) noexcept { return _mm_add_ps(a, b); }
 
-    void resize(size_t size) { this->storage.resize(size); }
-    void resize(size_t size, const T& value) { this->storage.resize(size, value); }
+    using Wide = double;
+    using WideVector = __m128d;
+    static WideVector wide_zero() noexcept { return _mm_setzero_pd(); }
+    static WideVector widen_low(Vector v) noexcept { return _mm_cvtps_pd(v); }
+    static WideVector widen_high(Vector v) noexcept { return _mm_cvtps_pd(_mm_movehl_ps(v, v)); }
+    static WideVector add_wide(WideVector a, WideVector b) noexcept { return _mm_add_pd(a, b); }
+    static void store_wide(Wide* ptr, WideVector v) noexcept { _mm_storeu_pd(ptr, v); }
+private:
+    static Vector blend(Vector mask, Vector a, Vector b) noexcept { return _mm_or_ps(_mm_and_ps(mask, a), _mm_andnot_ps(mask, b)); }
+};
 
-    void reserve(size_t size) { this->storage.reserve(size); }
-    auto capacity() const noexcept { return this->storage.capacity(); }
-    void shrink_to_fit() { this->storage.shrink_to_fit(); }
+#endif
 
-    void push_back(const T& value) { this->storage.push_back(value); }
-    void push_back(T&& value) { this->storage.push_back(std::move(value)); }
+template<typename Lanes>
+size_t find_lanes(const typename Lanes::Scalar* data, size_t size, typename Lanes::Scalar value) noexcept
+{
+    const auto pattern = Lanes::broadcast(value);
+    size_t i = 0;
+    for (; i + Lanes::width <= size; i += Lanes::width) {
+        int mask = Lanes::equal(Lanes::load(data + i), pattern);
+        if (mask != 0) {
+            for (; (mask & 1) == 0; mask >>= 1)
+                ++i;
+            return i;
+        }
+    }
+    return i + scalar::find(data + i, size - i, value);
+}
 
-    void assign(size_t count, const T& value) { this->storage.assign(count, value); }
-};
+template<typename Lanes>
+size_t count_lanes(const typename Lanes::Scalar* data, size_t size, typename Lanes::Scalar value) noexcept
+{
+    const auto pattern = Lanes::broadcast(value);
+    size_t result = 0;
+    size_t i = 0;
+    for (; i + Lanes::width <= size; i += Lanes::width)
+        result += std::bitset<Lanes::width>(Lanes::equal(Lanes::load(data + i), pattern)).count();
+    return result + scalar::count(data + i, size - i, value);
+}
 
-template<typename T, template <typename> typename Allocator = std::allocator>
-class SoAVector : public RandomAccessContainer<SoARandomAccessContainer<T, VectorBinder<Allocator>::template type>>
+template<typename Lanes>
+auto minmax_lanes(const typename Lanes::Scalar* data, size_t size) noexcept
 {
-    using Base = RandomAccessContainer<SoARandomAccessContainer<T, VectorBinder<Allocator>::template type>>;
-    static_assert(!Base::has_bool(), "AoAoAoTT does not support vectors with Booleans");
-public:
-    SoAVector() : SoAVector(0) { }
-    explicit SoAVector(size_t s) { resize(s); }
-    SoAVector(size_t s, const T& value) { resize(s, value); }
+    using Scalar = typename Lanes::Scalar;
+    if (size < Lanes::width)
+        return scalar::minmax(data, size);
 
-    void resize(size_t s)
-    {
-        if constexpr(std::is_trivially_constructible_v<T>)
-            resize_memory(s);
-        else
-            resize(s, T());
+    auto low = Lanes::load(data);
+    auto high = low;
+    size_t i = Lanes::width;
+    for (; i + Lanes::width <= size; i += Lanes::width) {
+        const auto v = Lanes::load(data + i);
+        low = Lanes::min(low, v);
+        high = Lanes::max(high, v);
     }
 
-    void resize(size_t s, const T& value)
-    {
-        size_t old_size = this->size();
-        resize_memory(s);
-        this->replicate( value, old_size, s);
-    }
+    Scalar lows[Lanes::width];
+    Scalar highs[Lanes::width];
+    Lanes::store(lows, low);
+    Lanes::store(highs, high);
+    // A lane is NaN in both vectors only if all its values are NaN
+    auto result = scalar::minmax(lows, Lanes::width);
+    result.second = scalar::minmax(highs, Lanes::width).second;
+    if (i < size)
+        scalar::merge_minmax(result, scalar::minmax(data + i, size - i));
+    return result;
+}
 
-    auto capacity() const noexcept { return std::get<0>(this->storage).capacity(); }
-    void reserve(size_t s) { apply([s](auto& v){ v.reserve(s); }); }
-    void shrink_to_fit()   { apply([](auto& v){ v.shrink_to_fit(); }); }
+// Note that the order of floating-point additions differs from the sequential one
+template<typename Lanes>
+auto sum_lanes(const typename Lanes::Scalar* data, size_t size, typename Lanes::Scalar init) noexcept
+{
+    using Scalar = typename Lanes::Scalar;
+    auto accumulator = Lanes::zero();
+    size_t i = 0;
+    for (; i + Lanes::width <= size; i += Lanes::width)
+        accumulator = Lanes::add(accumulator, Lanes::load(data + i));
 
-    void assign(size_t s, const T& value)
-    {
-        if (s > this->size())
-            resize(s, value);
-        else
-            this->replicate( value, 0, s);
+    Scalar lanes[Lanes::width];
+    Lanes::store(lanes, accumulator);
+    return scalar::sum(data + i, size - i, scalar::sum(lanes, Lanes::width, init));
+}
+
+// Sums into lanes of the wide type, the low and the high halves of each vector separately
+template<typename Lanes>
+auto sum_wide_lanes(const typename Lanes::Scalar* data, size_t size, typename Lanes::Wide init) noexcept
+{
+    using Wide = typename Lanes::Wide;
+    auto low = Lanes::wide_zero();
+    auto high = Lanes::wide_zero();
+    size_t i = 0;
+    for (; i + Lanes::width <= size; i += Lanes::width) {
+        const auto v = Lanes::load(data + i);
+        low = Lanes::add_wide(low, Lanes::widen_low(v));
+        high = Lanes::add_wide(high, Lanes::widen_high(v));
     }
 
-    void push_back(const T& value)
+    Wide lanes[Lanes::width];
+    Lanes::store_wide(lanes, low);
+    Lanes::store_wide(lanes + Lanes::width / 2, high);
+    return scalar::sum(data + i, size - i, scalar::sum(lanes, Lanes::width, init));
+}
+
+inline size_t find(const int32_t* data, size_t size, int32_t value) noexcept { return find_lanes<Int32Lanes>(data, size, value); }
+inline size_t find(const float* data, size_t size, float value) noexcept { return find_lanes<FloatLanes>(data, size, value); }
+inline size_t count(const int32_t* data, size_t size, int32_t value) noexcept { return count_lanes<Int32Lanes>(data, size, value); }
+inline size_t count(const float* data, size_t size, float value) noexcept { return count_lanes<FloatLanes>(data, size, value); }
+inline auto minmax(const int32_t* data, size_t size) noexcept { return minmax_lanes<Int32Lanes>(data, size); }
+inline auto minmax(const float* data, size_t size) noexcept { return minmax_lanes<FloatLanes>(data, size); }
+inline int32_t sum(const int32_t* data, size_t size, int32_t init) noexcept { return sum_lanes<Int32Lanes>(data, size, init); }
+inline float sum(const float* data, size_t size, float init) noexcept { return sum_lanes<FloatLanes>(data, size, init); }
+inline int64_t sum(const int32_t* data, size_t size, int64_t init) noexcept { return sum_wide_lanes<Int32Lanes>(data, size, init); }
+inline double sum(const float* data, size_t size, double init) noexcept { return sum_wide_lanes<FloatLanes>(data, size, init); }
+
+#if defined(__AVX2__)
+
+// Byte indices of 32-bit lanes, which left-pack the kept elements of 'width' lanes for each mask of them
+template<size_t width>
+struct CompactPermutations
+{
+    uint8_t indices[1 << width][8];
+
+    constexpr CompactPermutations() : indices{}
     {
-        auto s = this->size();
-        resize_memory(s + 1);
-        this->dissipate(value, s);
+        constexpr size_t lanes = 8 / width;
+        for (size_t keep = 0; keep < (1 << width); ++keep) {
+            size_t n = 0;
+            for (size_t j = 0; j < width; ++j)
+                if ((keep >> j) & 1)
+                    for (size_t h = 0; h < lanes; ++h)
+                        indices[keep][n++] = uint8_t(j * lanes + h);
+        }
     }
+};
 
-    void push_back(T&& value)
-    {
-        auto s = this->size();
-        resize_memory(s + 1);
-        this->dissipate(std::move(value), s);
+// Left-packs a vector of elements by a permutation of its 32-bit lanes. The whole vector is stored,
+// which is safe, since the destination is behind the source and the rest is overwritten later.
+template<typename R>
+size_t compact_lanes(R* data, const char* mask, size_t result, size_t first, size_t size) noexcept
+{
+    constexpr size_t width = sizeof(__m256i) / sizeof(R);
+    static constexpr CompactPermutations<width> permutations{};
+    size_t i = first;
+    for (; i + width <= size; i += width) {
+        uint64_t erased = 0;
+        std::memcpy(&erased, mask + i, width);
+        const unsigned keep = _mm_movemask_epi8(_mm_cmpeq_epi8(_mm_cvtsi64_si128(int64_t(erased)), _mm_setzero_si128())) & ((1u << width) - 1);
+        const auto order = _mm256_cvtepu8_epi32(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(permutations.indices[keep])));
+        const auto v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(data + result), _mm256_permutevar8x32_epi32(v, order));
+        result += std::bitset<width>(keep).count();
     }
+    return scalar::compact(data, mask, result, i, size);
+}
 
-private:
-    void resize_memory(size_t s) { apply([s](auto& v){ v.resize(s); }); }
+template<typename R, typename = std::enable_if_t<std::is_trivially_copyable_v<R> && (sizeof(R) == 4 || sizeof(R) == 8)>>
+size_t compact(R* data, const char* mask, size_t result, size_t first, size_t size) noexcept { return compact_lanes(data, mask, result, first, size); }
 
-    template <typename F>
-    void apply(F fun)
-    {
+#endif
+
+#endif
+
+} // namespace kernels
+
+template<typename Column>
+class ShiftedColumn
+{
+public:
+    ShiftedColumn(const Column& c, size_t o) noexcept : column(c), offset(o) { }
+    decltype(auto) operator[](size_t index) const noexcept { return column[offset + index]; }
+    const Column& base() const noexcept { return column; }
+    size_t shift() const noexcept { return offset; }
+private:
+    const Column& column;
+    const size_t offset;
+};
+
+namespace kernels {
+
+// Chunked columns are scanned chunk by chunk, so the contiguous kernels apply within each chunk.
+// Calls f(data, count, position) for consecutive pieces until it returns false.
+template<typename Column, typename F>
+void for_each_chunk(const ShiftedColumn<Column>& column, size_t size, F f)
+{
+    constexpr size_t chunk_size = Column::chunk_size;
+    for (size_t position = 0; position < size;) {
+        const size_t index = column.shift() + position;
+        const size_t length = std::min(chunk_size - index % chunk_size, size - position);
+        if (!f(column.base().chunk(index / chunk_size) + index % chunk_size, length, position))
+            return;
+        position += length;
+    }
+}
+
+template<typename Column, typename R, typename = std::enable_if_t<IsChunked<Column>::value>>
+size_t find(const ShiftedColumn<Column>& column, size_t size, const R& value)
+{
+    size_t result = size;
+    for_each_chunk(column, size, [&](const auto* data, size_t length, size_t position) {
+        const size_t i = find(data, length, value);
+        if (i < length)
+            result = position + i;
+        return i == length;
+    });
+    return result;
+}
+
+template<typename Column, typename R, typename = std::enable_if_t<IsChunked<Column>::value>>
+size_t count(const ShiftedColumn<Column>& column, size_t size, const R& value)
+{
+    size_t result = 0;
+    for_each_chunk(column, size, [&](const auto* data, size_t length, size_t) {
+        result += kernels::count(data, length, value);
+        return true;
+    });
+    return result;
+}
+
+template<typename Column, typename = std::enable_if_t<IsChunked<Column>::value>>
+auto minmax(const ShiftedColumn<Column>& column, size_t size)
+{
+    using R = std::remove_cv_t<std::remove_reference_t<decltype(column[0])>>;
+    assert(size > 0);
+    std::pair<R, R> result(column[0], column[0]);
+    for_each_chunk(column, size, [&](const auto* data, size_t length, size_t) {
+        scalar::merge_minmax(result, minmax(data, length));
+        return true;
+    });
+    return result;
+}
+
+template<typename Column, typename U, typename = std::enable_if_t<IsChunked<Column>::value>>
+U sum(const ShiftedColumn<Column>& column, size_t size, U init)
+{
+    for_each_chunk(column, size, [&](const auto* data, size_t length, size_t) {
+        init = sum(data, length, init);
+        return true;
+    });
+    return init;
+}
+
+} // namespace kernels
+
+// Returns a raw pointer for contiguous columns, so scan kernels can use SIMD, or a column accessor otherwise
+template<typename Column>
+auto column_begin(const Column& column, size_t offset = 0) noexcept
+{
+    if constexpr (IsContiguous<Column>::value)
+        return column.data() + offset;
+    else
+        return ShiftedColumn<Column>(column, offset);
+}
+
+// Lazy column expressions. Operators on columns build a tree of nodes, which is evaluated
+// element by element in a single pass on assignment or reduction, so no temporaries are created.
+// Leaves of contiguous columns are raw pointers, so the fused loop is vectorized for SoA containers.
+namespace expressions {
+
+static constexpr size_t unbounded = size_t(-1);
+
+template<typename Derived>
+class Expression
+{
+public:
+    const Derived& self() const noexcept { return static_cast<const Derived&>(*this); }
+
+    auto sum() const
+    {
+        SumType<std::decay_t<decltype(self()[0])>> result{};
+        for (size_t i = 0; i < self().size(); ++i)
+            result += self()[i];
+        return result;
+    }
+
+    // Number of elements which are true, e.g. (col<&A::x>() > 0).count()
+    size_t count() const
+    {
+        size_t result = 0;
+        for (size_t i = 0; i < self().size(); ++i)
+            result += self()[i] ? 1 : 0;
+        return result;
+    }
+
+    auto min() const { return reduce([](const auto& a, const auto& b) { return b < a ? b : a; }); }
+    auto max() const { return reduce([](const auto& a, const auto& b) { return a < b ? b : a; }); }
+
+    bool any() const { return count() > 0; }
+    bool all() const { return count() == self().size(); }
+
+private:
+    template<typename F>
+    auto reduce(F f) const
+    {
+        assert(self().size() > 0);
+        std::decay_t<decltype(self()[0])> result = self()[0];
+        for (size_t i = 1; i < self().size(); ++i)
+            result = f(result, self()[i]);
+        return result;
+    }
+};
+
+template<typename E>
+static constexpr bool is_expression = std::is_base_of_v<Expression<E>, E>;
+
+// Column accessor which is not copied to the leaf
+template<typename Column>
+class Indirect
+{
+public:
+    explicit Indirect(Column& c) noexcept : column(&c) { }
+    decltype(auto) operator[](size_t index) const noexcept { return (*column)[index]; }
+private:
+    Column* column;
+};
+
+// Pointer to data of contiguous columns, a copy of value accessors, or an indirect reference otherwise
+template<typename Column>
+auto make_accessor(Column&& column) noexcept
+{
+    using C = std::remove_reference_t<Column>;
+    if constexpr (IsContiguous<std::remove_cv_t<C>>::value)
+        return column.data();
+    else if constexpr (std::is_lvalue_reference_v<Column>)
+        return Indirect<C>(column);
+    else
+        return std::remove_cv_t<C>(column);
+}
+
+// Accessor for writes: copy-on-write columns expose only const data, so they are written by operator[]
+template<typename Column>
+auto make_writer(Column&& column) noexcept
+{
+    using C = std::remove_reference_t<Column>;
+    if constexpr (IsContiguous<std::remove_cv_t<C>>::value && !IsWritableContiguous<C>::value)
+        return Indirect<C>(column);
+    else
+        return make_accessor(std::forward<Column>(column));
+}
+
+template<typename Accessor>
+class Leaf : public Expression<Leaf<Accessor>>
+{
+public:
+    Leaf(Accessor a, size_t s) noexcept : accessor(a), length(s) { }
+    decltype(auto) operator[](size_t index) const noexcept { return accessor[index]; }
+    size_t size() const noexcept { return length; }
+private:
+    Accessor accessor;
+    size_t length;
+};
+
+template<typename Column>
+auto make_leaf(Column&& column, size_t size) noexcept
+{
+    auto accessor = make_accessor(std::forward<Column>(column));
+    return Leaf<decltype(accessor)>(accessor, size);
+}
+
+template<typename U>
+class Scalar : public Expression<Scalar<U>>
+{
+public:
+    explicit Scalar(U v) noexcept : value(v) { }
+    U operator[](size_t) const noexcept { return value; }
+    static constexpr size_t size() noexcept { return unbounded; }
+private:
+    U value;
+};
+
+template<typename Op, typename E>
+class Unary : public Expression<Unary<Op, E>>
+{
+public:
+    explicit Unary(const E& e) noexcept : operand(e) { }
+    auto operator[](size_t index) const noexcept { return Op{}(operand[index]); }
+    size_t size() const noexcept { return operand.size(); }
+private:
+    E operand;
+};
+
+template<typename Op, typename L, typename R>
+class Binary : public Expression<Binary<Op, L, R>>
+{
+public:
+    Binary(const L& l, const R& r) noexcept : lhs(l), rhs(r) { }
+    auto operator[](size_t index) const noexcept { return Op{}(lhs[index], rhs[index]); }
+    size_t size() const noexcept { return std::min(lhs.size(), rhs.size()); }
+private:
+    L lhs;
+    R rhs;
+};
+
+template<typename M, typename A, typename B>
+class Select : public Expression<Select<M, A, B>>
+{
+public:
+    Select(const M& m, const A& a, const B& b) noexcept : mask(m), on_true(a), on_false(b) { }
+    auto operator[](size_t index) const noexcept { return mask[index] ? on_true[index] : on_false[index]; }
+    size_t size() const noexcept { return std::min({ mask.size(), on_true.size(), on_false.size() }); }
+private:
+    M mask;
+    A on_true;
+    B on_false;
+};
+
+template<typename E>
+auto as_expression(const E& e) noexcept
+{
+    if constexpr (is_expression<E>)
+        return e;
+    else
+        return Scalar<E>(e);
+}
+
+template<typename L, typename R>
+static constexpr bool are_operands = (is_expression<L> && (is_expression<R> || std::is_arithmetic_v<R>))
+                                  || (std::is_arithmetic_v<L> && is_expression<R>);
+
+struct ShiftLeft  { template<typename L, typename R> auto operator()(const L& l, const R& r) const noexcept { return l << r; } };
+struct ShiftRight { template<typename L, typename R> auto operator()(const L& l, const R& r) const noexcept { return l >> r; } };
+
+#define AO_AO_AO_TT_BINARY(OP, FUNCTOR) \
+    template<typename L, typename R, typename = std::enable_if_t<are_operands<L, R>>> \
+    auto operator OP(const L& l, const R& r) noexcept \
+    { \
+        return Binary<FUNCTOR, decltype(as_expression(l)), decltype(as_expression(r))>(as_expression(l), as_expression(r)); \
+    }
+
+AO_AO_AO_TT_BINARY(+,  std::plus<>)
+AO_AO_AO_TT_BINARY(-,  std::minus<>)
+AO_AO_AO_TT_BINARY(*,  std::multiplies<>)
+AO_AO_AO_TT_BINARY(/,  std::divides<>)
+AO_AO_AO_TT_BINARY(%,  std::modulus<>)
+AO_AO_AO_TT_BINARY(&,  std::bit_and<>)
+AO_AO_AO_TT_BINARY(|,  std::bit_or<>)
+AO_AO_AO_TT_BINARY(^,  std::bit_xor<>)
+AO_AO_AO_TT_BINARY(<<, ShiftLeft)
+AO_AO_AO_TT_BINARY(>>, ShiftRight)
+AO_AO_AO_TT_BINARY(==, std::equal_to<>)
+AO_AO_AO_TT_BINARY(!=, std::not_equal_to<>)
+AO_AO_AO_TT_BINARY(<,  std::less<>)
+AO_AO_AO_TT_BINARY(<=, std::less_equal<>)
+AO_AO_AO_TT_BINARY(>,  std::greater<>)
+AO_AO_AO_TT_BINARY(>=, std::greater_equal<>)
+AO_AO_AO_TT_BINARY(&&, std::logical_and<>)
+AO_AO_AO_TT_BINARY(||, std::logical_or<>)
+
+#undef AO_AO_AO_TT_BINARY
+
+template<typename E, typename = std::enable_if_t<is_expression<E>>>
+auto operator-(const E& e) noexcept { return Unary<std::negate<>, E>(e); }
+
+template<typename E, typename = std::enable_if_t<is_expression<E>>>
+auto operator~(const E& e) noexcept { return Unary<std::bit_not<>, E>(e); }
+
+template<typename E, typename = std::enable_if_t<is_expression<E>>>
+auto operator!(const E& e) noexcept { return Unary<std::logical_not<>, E>(e); }
+
+// Element-wise choice: mask[i] ? a[i] : b[i]
+template<typename M, typename A, typename B, typename = std::enable_if_t<is_expression<M>>>
+auto where(const M& mask, const A& a, const B& b) noexcept
+{
+    return Select<M, decltype(as_expression(a)), decltype(as_expression(b))>(mask, as_expression(a), as_expression(b));
+}
+
+// Writable column of a container, which evaluates expressions on assignment
+template<typename Container, auto field>
+class ColumnRef : public Expression<ColumnRef<Container, field>>
+{
+    using Accessor = decltype(make_accessor(std::declval<Container&>().template mutable_column<field>()));
+public:
+    explicit ColumnRef(Container* c) noexcept : base(c), accessor(make_accessor(c->template mutable_column<field>())) { }
+    ColumnRef(const ColumnRef&) = default;
+
+    decltype(auto) operator[](size_t index) const noexcept { return accessor[index]; }
+    size_t size() const noexcept { return base->size(); }
+
+    ColumnRef& operator=(const ColumnRef& rhs) { return assign(rhs, [](auto& dst, const auto& v) { dst = v; }); }
+
+    template<typename E>
+    ColumnRef& operator=(const E& e) { return assign(as_expression(e), [](auto& dst, const auto& v) { dst = v; }); }
+
+    template<typename E>
+    ColumnRef& operator+=(const E& e) { return assign(as_expression(e), [](auto& dst, const auto& v) { dst += v; }); }
+
+    template<typename E>
+    ColumnRef& operator-=(const E& e) { return assign(as_expression(e), [](auto& dst, const auto& v) { dst -= v; }); }
+
+    template<typename E>
+    ColumnRef& operator*=(const E& e) { return assign(as_expression(e), [](auto& dst, const auto& v) { dst *= v; }); }
+
+    template<typename M>
+    class Masked
+    {
+    public:
+        Masked(const ColumnRef& c, const M& m) noexcept : column(c), mask(m) { }
+
+        template<typename E>
+        void operator=(const E& e)
+        {
+            const auto value = as_expression(e);
+            column.assign(value, [&](auto& dst, const auto&, size_t i) { dst = mask[i] ? value[i] : dst; });
+        }
+
+    private:
+        ColumnRef column;
+        M mask;
+    };
+
+    // Assigns only elements where the mask is true, e.g. x.masked(y > 0) = z;
+    template<typename M>
+    auto masked(const M& mask) noexcept { return Masked<M>(*this, mask); }
+
+private:
+    template<typename E, typename F>
+    ColumnRef& assign(const E& e, F f)
+    {
+        const size_t n = size();
+        assert(e.size() == unbounded || e.size() == n);
+        base->template touch_column<field>(0, n);
+        // Copy-on-write columns are detached by the touch, so the destination is taken after it
+        const auto dst = make_writer(base->template mutable_column<field>());
+        for (size_t i = 0; i < n; ++i) {
+            if constexpr (std::is_invocable_v<F, decltype(dst[i]), decltype(e[i]), size_t>)
+                f(dst[i], e[i], i);
+            else
+                f(dst[i], e[i]);
+        }
+        return *this;
+    }
+
+    Container* base;
+    Accessor accessor;
+};
+
+} // namespace expressions
+
+using expressions::where;
+
+// Fixed-width pack of W values in the spirit of std::experimental::simd.
+// Operations are loops of constant length, which are unrolled and vectorized by compilers.
+template<typename U, size_t W>
+class Batch
+{
+public:
+    static constexpr size_t width = W;
+    using value_type = U;
+
+    Batch() = default;
+    Batch(U value) noexcept { values.fill(value); } // broadcast
+
+    U& operator[](size_t lane) noexcept { return values[lane]; }
+    const U& operator[](size_t lane) const noexcept { return values[lane]; }
+    static constexpr size_t size() noexcept { return W; }
+
+    // Loads 'count' values starting from 'first', the rest of lanes are value-initialized
+    template<typename Accessor>
+    static Batch load(const Accessor& accessor, size_t first, size_t count = W) noexcept
+    {
+        Batch result;
+        if (count == W)
+            for (size_t j = 0; j < W; ++j)
+                result.values[j] = accessor[first + j];
+        else
+            for (size_t j = 0; j < count; ++j)
+                result.values[j] = accessor[first + j];
+        return result;
+    }
+
+    template<typename Accessor>
+    void store(Accessor&& accessor, size_t first, size_t count = W) const noexcept
+    {
+        if (count == W)
+            for (size_t j = 0; j < W; ++j)
+                accessor[first + j] = values[j];
+        else
+            for (size_t j = 0; j < count; ++j)
+                accessor[first + j] = values[j];
+    }
+
+    U sum() const noexcept
+    {
+        U result{};
+        for (size_t j = 0; j < W; ++j)
+            result += values[j];
+        return result;
+    }
+
+    U min() const noexcept { return *std::min_element(values.begin(), values.end()); }
+    U max() const noexcept { return *std::max_element(values.begin(), values.end()); }
+
+    size_t count() const noexcept
+    {
+        size_t result = 0;
+        for (size_t j = 0; j < W; ++j)
+            result += values[j] ? 1 : 0;
+        return result;
+    }
+
+    bool any() const noexcept { return count() > 0; }
+    bool all() const noexcept { return count() == W; }
+
+#define AO_AO_AO_TT_BATCH_BINARY(OP, R) \
+    friend Batch<R, W> operator OP(const Batch& lhs, const Batch& rhs) noexcept \
+    { \
+        Batch<R, W> result; \
+        for (size_t j = 0; j < W; ++j) \
+            result[j] = lhs.values[j] OP rhs.values[j]; \
+        return result; \
+    }
+
+    AO_AO_AO_TT_BATCH_BINARY(+,  U)
+    AO_AO_AO_TT_BATCH_BINARY(-,  U)
+    AO_AO_AO_TT_BATCH_BINARY(*,  U)
+    AO_AO_AO_TT_BATCH_BINARY(/,  U)
+    AO_AO_AO_TT_BATCH_BINARY(%,  U)
+    AO_AO_AO_TT_BATCH_BINARY(&,  U)
+    AO_AO_AO_TT_BATCH_BINARY(|,  U)
+    AO_AO_AO_TT_BATCH_BINARY(^,  U)
+    AO_AO_AO_TT_BATCH_BINARY(<<, U)
+    AO_AO_AO_TT_BATCH_BINARY(>>, U)
+    AO_AO_AO_TT_BATCH_BINARY(==, bool)
+    AO_AO_AO_TT_BATCH_BINARY(!=, bool)
+    AO_AO_AO_TT_BATCH_BINARY(<,  bool)
+    AO_AO_AO_TT_BATCH_BINARY(<=, bool)
+    AO_AO_AO_TT_BATCH_BINARY(>,  bool)
+    AO_AO_AO_TT_BATCH_BINARY(>=, bool)
+    AO_AO_AO_TT_BATCH_BINARY(&&, bool)
+    AO_AO_AO_TT_BATCH_BINARY(||, bool)
+
+#undef AO_AO_AO_TT_BATCH_BINARY
+
+    friend Batch operator-(const Batch& batch) noexcept { return Batch(U{}) - batch; }
+
+    friend Batch<bool, W> operator!(const Batch& batch) noexcept
+    {
+        Batch<bool, W> result;
+        for (size_t j = 0; j < W; ++j)
+            result[j] = !batch.values[j];
+        return result;
+    }
+
+    // Lane-wise choice: mask[j] ? a[j] : b[j]
+    friend Batch where(const Batch<bool, W>& mask, const Batch& a, const Batch& b) noexcept
+    {
+        Batch result;
+        for (size_t j = 0; j < W; ++j)
+            result.values[j] = mask[j] ? a.values[j] : b.values[j];
+        return result;
+    }
+
+private:
+    std::array<U, W> values{};
+};
+
+// Result of ->* on mutable batch facades: loads the field on conversion and stores it on assignment
+template<typename B, typename Container, typename Member>
+class BatchField
+{
+public:
+    BatchField(Container* c, Member m, size_t i, size_t n) noexcept : base(c), member(m), index(i), count(n) { }
+    BatchField(const BatchField&) = default;
+
+    B load() const noexcept { return B::load(expressions::make_accessor(base->get_column(member)), index, count); }
+    operator B() const noexcept { return load(); }
+
+    // Stores only active lanes, so tails of containers are not overrun
+    const BatchField& operator=(const B& value) const noexcept(Container::nothrow_writes)
+    {
+        base->touch(member, index, index + count);
+        value.store(expressions::make_writer(base->get_mutable_column(member)), index, count);
+        return *this;
+    }
+
+    const BatchField& operator=(const BatchField& rhs) const noexcept(Container::nothrow_writes) { return *this = rhs.load(); }
+
+    // Stores lanes selected by the mask
+    void store_if(const Batch<bool, B::width>& mask, const B& value) const noexcept(Container::nothrow_writes) { *this = where(mask, value, load()); }
+
+private:
+    Container* base;
+    Member member;
+    size_t index;
+    size_t count;
+};
+
+// Facade of W consecutive elements starting from 'index'. The last batch of a container
+// may be partial: loads fill inactive lanes with value-initialized values, and stores skip them.
+// Batches starting at or past the end are empty.
+template<typename Container, size_t W>
+class BatchFacade
+{
+    using T = typename std::remove_const_t<Container>::value_type;
+public:
+    BatchFacade(Container* b, size_t i) noexcept : base(b), index(i), count(i < b->size() ? std::min(W, b->size() - i) : 0) { }
+
+    size_t get_index() const noexcept { return index; }
+    size_t size() const noexcept { return count; }
+
+    Batch<bool, W> mask() const noexcept
+    {
+        Batch<bool, W> result;
+        for (size_t j = 0; j < W; ++j)
+            result[j] = j < count;
+        return result;
+    }
+
+    template<typename R>
+    auto operator->*(R T::* field) const noexcept
+    {
+        using Member = R T::*;
+        if constexpr (std::is_const_v<Container>)
+            return Batch<std::remove_cv_t<R>, W>::load(expressions::make_accessor(base->get_column(field)), index, count);
+        else
+            return BatchField<Batch<std::remove_cv_t<R>, W>, Container, Member>(base, field, index, count);
+    }
+
+private:
+    Container* base;
+    size_t index;
+    size_t count;
+};
+
+// Range of batch facades with a stride of W elements
+template<typename Container, size_t W>
+class BatchRange
+{
+public:
+    class iterator
+    {
+    public:
+        iterator(Container* b, size_t i) noexcept : base(b), index(i) { }
+        auto operator*() const noexcept { return BatchFacade<Container, W>(base, index); }
+        iterator& operator++() noexcept { index += W; return *this; }
+        bool operator==(const iterator& rhs) const noexcept { return index == rhs.index; }
+        bool operator!=(const iterator& rhs) const noexcept { return index != rhs.index; }
+    private:
+        Container* base;
+        size_t index;
+    };
+
+    explicit BatchRange(Container* b) noexcept : base(b) { }
+    auto begin() const noexcept { return iterator(base, 0); }
+    auto end() const noexcept { return iterator(base, (base->size() + W - 1) / W * W); }
+
+private:
+    Container* base;
+};
+
+// Range of facades, which prefetches the fields of the element 'distance' positions ahead.
+// Elements are visited in order, or in the order of the index list if it is given.
+template<typename Container, typename Index, auto ... fields>
+class PrefetchRange
+{
+public:
+    class iterator
+    {
+    public:
+        iterator(const PrefetchRange& r, size_t p) noexcept : range(r), position(p) { }
+        auto operator*() const noexcept { return (*range.base)[range.index_at(position)]; }
+        iterator& operator++() noexcept { range.prefetch(++position + range.distance - 1); return *this; }
+        bool operator==(const iterator& rhs) const noexcept { return position == rhs.position; }
+        bool operator!=(const iterator& rhs) const noexcept { return position != rhs.position; }
+        size_t get_position() const noexcept { return position; }
+    private:
+        PrefetchRange range;
+        size_t position;
+    };
+
+    PrefetchRange(Container* b, const Index* i, size_t n, size_t d, Locality l) noexcept
+        : base(b), indices(i), count(n), distance(std::max<size_t>(d, 1)), locality(l) { }
+
+    // Warms up the first 'distance' elements
+    auto begin() const noexcept
+    {
+        for (size_t k = 0; k < distance; ++k)
+            prefetch(k);
+        return iterator(*this, 0);
+    }
+
+    auto end() const noexcept { return iterator(*this, count); }
+    size_t size() const noexcept { return count; }
+
+private:
+    size_t index_at(size_t position) const noexcept
+    {
+        if constexpr (std::is_void_v<Index>)
+            return position;
+        else
+            return static_cast<size_t>(indices[position]);
+    }
+
+    void prefetch(size_t position) const noexcept
+    {
+        if (position < count)
+            base->template prefetch<fields...>(index_at(position), locality);
+    }
+
+    Container* base;
+    const Index* indices;
+    size_t count;
+    size_t distance;
+    Locality locality;
+};
+
+template<typename Container, auto key, typename ... Aggregates>
+class GroupBy;
+
+template<typename BaseContainer>
+class RandomAccessContainer : public BaseContainer
+{
+public:
+    using size_type = size_t;
+    using difference_type = ptrdiff_t;
+    using reference = Facade<BaseContainer>;
+    using const_reference = ConstFacade<BaseContainer>;
+
+    constexpr auto operator[](size_t index) noexcept { return reference{ this, index}; }
+    constexpr auto operator[](size_t index) const noexcept { return const_reference{ this, index}; }
+
+    constexpr auto at(size_t index) { check_index(index); return operator[](index); }
+    constexpr auto at(size_t index) const { check_index(index); return operator[](index); }
+
+    class const_iterator : const_reference,
+        public boost::iterator_facade<const_iterator, const_reference const, std::random_access_iterator_tag, const const_reference&>
+    {
+        friend class RandomAccessContainer;
+        friend class boost::iterator_core_access;
+
+        const_iterator(const BaseContainer* base, size_t index) : const_reference(base, index) { }
+
+        const auto& dereference() const noexcept { return *this; }
+    };
+
+    class iterator : reference,
+        public boost::iterator_facade<iterator, reference, std::random_access_iterator_tag, const reference&>
+    {
+        friend class RandomAccessContainer;
+        friend class boost::iterator_core_access;
+
+        iterator(BaseContainer* base, size_t index) : reference(base, index) { }
+
+        const auto& dereference() const noexcept { return *this; }
+    public:
+        iterator(const iterator&) = default;
+        iterator& operator=(const iterator& rhs) noexcept { this->rebind(rhs); return *this; }
+    };
+
+    auto cbegin() const noexcept { return const_iterator{ this, 0}; }
+    auto cend() const noexcept { return const_iterator{ this, this->size()}; }
+    auto begin() const noexcept { return cbegin(); }
+    auto end() const noexcept { return cend(); }
+    auto begin() noexcept { return iterator{ this, 0}; }
+    auto end() noexcept { return iterator{ this, this->size()}; }
+
+    // std::reverse_iterator dereferences a temporary copy of the base iterator,
+    // so it would return a dangling reference to our facades.
+    // Instead, reverse iterators point directly to the element and walk backwards.
+    // rend() is at the index size_t(-1), one before the first element: indices are unsigned,
+    // so stepping back from 0 wraps around to it, and distances are computed modulo 2^64.
+    class const_reverse_iterator : const_reference,
+        public boost::iterator_facade<const_reverse_iterator, const_reference const, std::random_access_iterator_tag, const const_reference&>
+    {
+        friend class RandomAccessContainer;
+        friend class boost::iterator_core_access;
+
+        const_reverse_iterator(const BaseContainer* base, size_t index) : const_reference(base, index) { }
+
+        const auto& dereference() const noexcept { return *this; }
+        void increment() noexcept { const_reference::decrement(); }
+        void decrement() noexcept { const_reference::increment(); }
+        void advance(ptrdiff_t n) noexcept { const_reference::advance(-n); }
+        ptrdiff_t distance_to(const const_reverse_iterator& rhs) const noexcept { return -const_reference::distance_to(rhs); }
+    };
+
+    class reverse_iterator : reference,
+        public boost::iterator_facade<reverse_iterator, reference, std::random_access_iterator_tag, const reference&>
+    {
+        friend class RandomAccessContainer;
+        friend class boost::iterator_core_access;
+
+        reverse_iterator(BaseContainer* base, size_t index) : reference(base, index) { }
+
+        const auto& dereference() const noexcept { return *this; }
+        void increment() noexcept { reference::decrement(); }
+        void decrement() noexcept { reference::increment(); }
+        void advance(ptrdiff_t n) noexcept { reference::advance(-n); }
+        ptrdiff_t distance_to(const reverse_iterator& rhs) const noexcept { return -reference::distance_to(rhs); }
+    public:
+        reverse_iterator(const reverse_iterator&) = default;
+        reverse_iterator& operator=(const reverse_iterator& rhs) noexcept { this->rebind(rhs); return *this; }
+    };
+
+    auto crbegin() const noexcept { return const_reverse_iterator{ this, this->size() - 1}; }
+    auto crend() const noexcept { return const_reverse_iterator{ this, size_t(-1)}; }
+    auto rbegin() const noexcept { return crbegin(); }
+    auto rend() const noexcept { return crend(); }
+    auto rbegin() noexcept { return reverse_iterator{ this, this->size() - 1}; }
+    auto rend() noexcept { return reverse_iterator{ this, size_t(-1)}; }
+
+    // Read-only access to all values of the field:
+    // a contiguous container for SoA, or an accessor with a stride for AoS
+    // Nested members are addressed by paths, e.g. column<&Outer::inner, &Inner::x>()
+    template<auto field, auto ... path>
+    decltype(auto) column() const noexcept
+    {
+        if constexpr (sizeof...(path) == 0)
+            return this->get_column(field);
+        else
+            return this->template get_path_column<field, path...>();
+    }
+
+    // Lazy column expressions, which are fused into a single pass on assignment or reduction:
+    // storage.col<&A::x>() = storage.col<&A::y>() << storage.col<&A::z>();
+    // Expressions keep pointers to columns, so they must not outlive resizes of the container.
+    template<auto field>
+    auto col() const noexcept { return expressions::make_leaf(this->get_column(field), this->size()); }
+
+    template<auto field>
+    auto col() noexcept { return expressions::ColumnRef<RandomAccessContainer, field>(this); }
+
+    // Facades of W consecutive elements, whose fields are loaded and stored as Batch values:
+    // auto b = storage.batch<8>(i); b->*(&A::x) = (b->*(&A::y)) << (b->*(&A::z));
+    template<size_t W>
+    auto batch(size_t index) noexcept { return BatchFacade<RandomAccessContainer, W>(this, index); }
+
+    template<size_t W>
+    auto batch(size_t index) const noexcept { return BatchFacade<const RandomAccessContainer, W>(this, index); }
+
+    template<size_t W>
+    auto batches() noexcept { return BatchRange<RandomAccessContainer, W>(this); }
+
+    template<size_t W>
+    auto batches() const noexcept { return BatchRange<const RandomAccessContainer, W>(this); }
+
+    // Software prefetch of the fields of the element, or of the whole element if no fields are given.
+    // SoA containers issue a prefetch per column, AoS containers per cache line of the element.
+    template<auto ... fields>
+    void prefetch(size_t index, Locality locality = Locality::high) const noexcept
+    {
+        if constexpr (sizeof...(fields) == 0)
+            this->prefetch_element(index, locality);
+        else
+            ((void)this->prefetch_member(fields, index, locality), ...);
+    }
+
+    // Iteration, which prefetches the fields 'distance' elements ahead:
+    // for (auto e : storage.prefetching<&A::x, &A::y>(16)) ...
+    template<auto ... fields>
+    auto prefetching(size_t distance = 16, Locality locality = Locality::high) noexcept
+    {
+        return PrefetchRange<RandomAccessContainer, void, fields...>(this, nullptr, this->size(), distance, locality);
+    }
+
+    template<auto ... fields>
+    auto prefetching(size_t distance = 16, Locality locality = Locality::high) const noexcept
+    {
+        return PrefetchRange<const RandomAccessContainer, void, fields...>(this, nullptr, this->size(), distance, locality);
+    }
+
+    // Indirect iteration over the elements of the index list, e.g. for gathers and joins.
+    // The list must stay alive during the iteration.
+    template<auto ... fields, typename Indices>
+    auto prefetching_at(const Indices& indices, size_t distance = 16, Locality locality = Locality::high) noexcept
+    {
+        using Index = std::remove_cv_t<std::remove_reference_t<decltype(*std::data(indices))>>;
+        return PrefetchRange<RandomAccessContainer, Index, fields...>(this, std::data(indices), std::size(indices), distance, locality);
+    }
+
+    template<auto ... fields, typename Indices>
+    auto prefetching_at(const Indices& indices, size_t distance = 16, Locality locality = Locality::high) const noexcept
+    {
+        using Index = std::remove_cv_t<std::remove_reference_t<decltype(*std::data(indices))>>;
+        return PrefetchRange<const RandomAccessContainer, Index, fields...>(this, std::data(indices), std::size(indices), distance, locality);
+    }
+
+    // Column of the L-th leaf field of SoA containers: fields of T in order,
+    // where deep layouts replace nested aggregates by their own leaf fields
+    template<size_t L>
+    const auto& leaf_column() const noexcept { return this->template get_leaf_column<L>(); }
+
+    // Column of j-th elements of a std::array field, contiguous if the layout transposes arrays
+    template<auto field>
+    decltype(auto) column(size_t j) const noexcept { return this->get_element_column(field, j); }
+
+    template<auto key>
+    auto group_by() const noexcept { return GroupBy<RandomAccessContainer, key>(*this); }
+
+    // Column algorithms, which scan only the specified field.
+    // SoA containers use SIMD kernels where possible, AoS containers use strided loads.
+    template<auto field>
+    auto find(const MemberType<field>& value) const { return const_iterator{ this, scan_find<field>(value)}; }
+
+    template<auto field>
+    auto find(const MemberType<field>& value) { return iterator{ this, scan_find<field>(value)}; }
+
+    template<auto field>
+    size_t count(const MemberType<field>& value) const
+    {
+        return scan<field>([&](const auto& column) { return kernels::count(column, this->size(), value); });
+    }
+
+    template<auto field>
+    auto minmax() const
+    {
+        assert(!this->empty());
+        return scan<field>([&](const auto& column) { return kernels::minmax(column, this->size()); });
+    }
+
+    template<auto field>
+    auto min() const { return minmax<field>().first; }
+
+    template<auto field>
+    auto max() const { return minmax<field>().second; }
+
+    // Sums in a widened type by default, pass 'init' to accumulate in another type
+    template<auto field, typename U = SumType<MemberType<field>>>
+    U sum(U init = U{}) const
+    {
+        return scan<field>([&](const auto& column) { return kernels::sum(column, this->size(), init); });
+    }
+
+    template<auto field, typename Predicate>
+    bool any_of(Predicate pred) const
+    {
+        return scan<field>([&](const auto& column) {
+            for (size_t i = 0; i < this->size(); ++i)
+                if (pred(column[i]))
+                    return true;
+            return false;
+        });
+    }
+
+    // Dirty ranges of containers with DirtyTracking policy: runs of modified blocks
+    // of the field, merged and clamped by the size of the container
+    template<auto field, typename F>
+    void for_each_dirty(F f) const
+    {
+        this->visit_dirty(this->member_to_index(field), this->size(), f);
+    }
+
+    // Calls f(column, first, last) for dirty ranges of all fields, 'column' is the index of the field
+    template<typename F>
+    void for_each_dirty(F f) const
+    {
+        for (size_t c = 0; c < this->field_count(); ++c)
+            this->visit_dirty(c, this->size(), [&](size_t first, size_t last) { f(c, first, last); });
+    }
+
+    template<auto field>
+    void clear_dirty() noexcept { this->reset_dirty(this->member_to_index(field)); }
+    void clear_dirty() noexcept { this->reset_dirty(); }
+
+    // Bulk writes of containers with WriteLog policy: the generation grows with each write,
+    // and f(first, last) is called for ranges written after the generation 'since'
+    uint64_t write_generation() const noexcept { return this->logged_generation(); }
+
+    template<typename F>
+    void visit_writes(uint64_t since, F f) const { this->visit_logged(since, f); }
+
+    auto front() const { return *begin(); }
+    auto front() { return *begin(); }
+
+    auto back() const { auto tmp = end(); --tmp; return *tmp; }
+    auto back() { auto tmp = end(); --tmp; return *tmp; }
+
+protected:
+    template<typename, auto> friend class expressions::ColumnRef;
+    template<typename, typename, typename> friend class BatchField;
+    template<typename, size_t> friend class BatchFacade;
+
+    template<auto field>
+    decltype(auto) mutable_column() noexcept { return this->get_mutable_column(field); }
+
+    template<auto field>
+    void touch_column(size_t first, size_t last) noexcept(BaseContainer::nothrow_writes) { this->touch(field, first, last); this->log_write(first, last); }
+
+    // Marks elements to be erased and returns the index of the first one
+    template<auto ... fields, typename Predicate>
+    size_t select(Predicate pred, std::vector<char>& mask) const
+    {
+        mask.resize(this->size());
+        auto fill = [&](const auto& ... column) {
+            for (size_t i = 0; i < mask.size(); ++i)
+                mask[i] = pred(column[i]...) ? 1 : 0;
+        };
+        fill(this->get_column(fields)...);
+        return std::find(mask.begin(), mask.end(), 1) - mask.begin();
+    }
+
+    // Left-pack of a column. Since 'first' is the first erased element, it is skipped.
+    // Contiguous columns of 4- and 8-byte trivially copyable types are packed by SIMD permutations.
+    template<typename Column>
+    static size_t compact(Column& column, const std::vector<char>& mask, size_t first)
+    {
+        if constexpr (IsWritableContiguous<Column>::value)
+            return kernels::compact(column.data(), mask.data(), first, first + 1, mask.size());
+        else
+            return kernels::scalar::compact<Column&>(column, mask.data(), first, first + 1, mask.size());
+    }
+
+private:
+    template<auto field, typename F>
+    auto scan(F fun) const
+    {
+        return fun(column_begin(this->get_column(field)));
+    }
+
+    template<auto field>
+    size_t scan_find(const MemberType<field>& value) const
+    {
+        return scan<field>([&](const auto& column) { return kernels::find(column, this->size(), value); });
+    }
+
+    constexpr void check_index(size_t index) const
+    {
+        if (index >= this->size())
+            throw std::out_of_range("SoA container is out of range");
+    }
+};
+
+template<typename T, size_t N, typename Base>
+class BaseArray : public Base
+{
+public:
+    BaseArray() = default;
+
+    // Copies the elements one by one, so constant tables may be evaluated at compile time:
+    // static constexpr SoAArray<A, 2> table({ A{1, 2}, A{3, 4} });
+    constexpr BaseArray(const T (&values)[N]) noexcept
+    {
+        for (size_t i = 0; i < N; ++i)
+            this->dissipate(values[i], i);
+    }
+
+    void fill(const T& value) { this->replicate( value, 0, N); }
+};
+
+template<size_t N>
+struct ArrayBinder
+{
+    template<typename T> using type = std::array<T, N>;
+};
+
+template<typename T, size_t N, typename Tracking = NoTracking>
+using AoSArray = BaseArray<T, N, RandomAccessContainer<AoSRandomAccessContainer<T, ArrayBinder<N>::template type, Tracking>>>;
+
+template<typename T, size_t N, typename Tracking = NoTracking>
+using SoAArray = BaseArray<T, N, RandomAccessContainer<SoARandomAccessContainer<T, ArrayBinder<N>::template type, Tracking>>>;
+
+template<template <typename> typename Allocator>
+struct VectorBinder
+{
+    template<typename T> using type = std::vector<T, Allocator<T>>;
+};
+
+template<typename T>
+class FrozenSoAVector;
+
+template<typename T, typename Base>
+class BaseAoSVector : public Base
+{
+public:
+    BaseAoSVector() { }
+    explicit BaseAoSVector(size_t size) { resize(size); }
+    BaseAoSVector(size_t size, const T& value) { resize(size, value); }
+
+    void resize(size_t size) { this->touch(this->size(), size); this->log_write(this->size(), size); this->storage.resize(size); }
+    void resize(size_t size, const T& value) { this->touch(this->size(), size); this->log_write(this->size(), size); this->storage.resize(size, value); }
+
+    void reserve(size_t size) { this->storage.reserve(size); }
+    auto capacity() const noexcept { return this->storage.capacity(); }
+    void shrink_to_fit() { this->storage.shrink_to_fit(); }
+
+    void push_back(const T& value) { this->touch(this->size(), this->size() + 1); this->log_write(this->size(), this->size() + 1); this->storage.push_back(value); }
+    void push_back(T&& value) { this->touch(this->size(), this->size() + 1); this->log_write(this->size(), this->size() + 1); this->storage.push_back(std::move(value)); }
+    void pop_back() { this->storage.resize(this->size() - 1); }
+
+    // Existing elements are overwritten in place, so large assignments may use non-temporal stores
+    void assign(size_t count, const T& value)
+    {
+        const size_t kept = std::min(count, this->size());
+        this->storage.resize(kept);
+        this->replicate(value, 0, kept);
+        resize(count, value);
+    }
+
+    // Copies elements of any container, which provides size() and operator[] convertible to T,
+    // e.g. converts SoA containers to AoS. Large copies use non-temporal stores.
+    template<typename Container>
+    void assign(const Container& source)
+    {
+        this->storage.resize(source.size());
+        this->convert(source, source.size());
+    }
+
+    template<auto ... fields, typename Predicate>
+    size_t erase_if(Predicate pred)
+    {
+        std::vector<char> mask;
+        const size_t first = this->template select<fields...>(pred, mask);
+        this->touch(first, mask.size());
+        this->log_write(first, mask.size());
+        const size_t s = this->compact(this->storage, mask, first);
+        this->storage.resize(s);
+        return mask.size() - s;
+    }
+
+    auto freeze() const { return FrozenSoAVector<T>(*this); }
+};
+
+template<typename T, template <typename> typename Allocator = std::allocator, typename Tracking = NoTracking>
+using AoSVector = BaseAoSVector<T, RandomAccessContainer<AoSRandomAccessContainer<T, VectorBinder<Allocator>::template type, Tracking>>>;
+
+template<typename T, typename Base>
+class BaseSoAVector : public Base
+{
+    static_assert(!Base::has_bool(), "AoAoAoTT does not support vectors with Booleans");
+public:
+    BaseSoAVector() : BaseSoAVector(0) { }
+    explicit BaseSoAVector(size_t s) { resize(s); }
+    BaseSoAVector(size_t s, const T& value) { resize(s, value); }
+
+    void resize(size_t s)
+    {
+        if constexpr(std::is_trivially_constructible_v<T>)
+            resize_memory(s);
+        else
+            resize(s, T());
+    }
+
+    void resize(size_t s, const T& value)
+    {
+        size_t old_size = this->size();
+        resize_memory(s);
+        this->replicate( value, old_size, s);
+    }
+
+    auto capacity() const noexcept { return std::get<0>(this->storage).capacity(); }
+    void reserve(size_t s) { apply([s](auto& v){ v.reserve(s); }); }
+    void shrink_to_fit()   { apply([](auto& v){ v.shrink_to_fit(); }); }
+
+    void assign(size_t s, const T& value)
+    {
+        resize_memory(s);
+        this->replicate( value, 0, s);
+    }
+
+    // Copies elements of any container, which provides size() and operator[] convertible to T,
+    // e.g. converts AoS containers to SoA. Large copies use non-temporal stores.
+    template<typename Container>
+    void assign(const Container& source)
+    {
+        resize_memory(source.size());
+        this->convert(source, source.size());
+    }
+
+    void push_back(const T& value)
+    {
+        auto s = this->size();
+        resize_memory(s + 1);
+        this->dissipate(value, s);
+    }
+
+    void push_back(T&& value)
+    {
+        auto s = this->size();
+        resize_memory(s + 1);
+        this->dissipate(std::move(value), s);
+    }
+
+    void pop_back() { resize_memory(this->size() - 1); }
+
+    // Read-only copy with compressed columns
+    auto freeze() const { return FrozenSoAVector<T>(*this); }
+
+    // Computes the mask from 'fields' columns only, then compacts each column in a single pass
+    template<auto ... fields, typename Predicate>
+    size_t erase_if(Predicate pred)
+    {
+        std::vector<char> mask;
+        const size_t first = this->template select<fields...>(pred, mask);
+        this->touch(first, mask.size());
+        this->log_write(first, mask.size());
+        size_t s = first;
+        apply([&](auto& v){ s = this->compact(v, mask, first); });
+        resize_memory(s);
+        return mask.size() - s;
+    }
+
+private:
+    void resize_memory(size_t s)
+    {
+        this->touch(this->size(), s);
+        this->log_write(this->size(), s);
+        apply([s](auto& v){ v.resize(s); });
+    }
+
+    template <typename F>
+    void apply(F fun)
+    {
         std::apply([fun](auto& ...x){(..., fun(x));}, this->storage);
     }
 };
 
+template<typename T, template <typename> typename Allocator = std::allocator, typename Tracking = NoTracking>
+using SoAVector = BaseSoAVector<T, RandomAccessContainer<SoARandomAccessContainer<T, VectorBinder<Allocator>::template type, Tracking>>>;
+
+// SoA containers which split nested aggregates to columns of their leaf fields
+template<typename T, size_t N, typename Tracking = NoTracking>
+using DeepSoAArray = BaseArray<T, N, RandomAccessContainer<SoARandomAccessContainer<T, ArrayBinder<N>::template type, Tracking, DeepLayout>>>;
+
+template<typename T, template <typename> typename Allocator = std::allocator, typename Tracking = NoTracking>
+using DeepSoAVector = BaseSoAVector<T, RandomAccessContainer<SoARandomAccessContainer<T, VectorBinder<Allocator>::template type, Tracking, DeepLayout>>>;
+
+// SoA containers which split std::array fields to a column per element
+template<typename T, size_t N, typename Tracking = NoTracking>
+using TransposedSoAArray = BaseArray<T, N, RandomAccessContainer<SoARandomAccessContainer<T, ArrayBinder<N>::template type, Tracking, TransposedLayout>>>;
+
+template<typename T, template <typename> typename Allocator = std::allocator, typename Tracking = NoTracking>
+using TransposedSoAVector = BaseSoAVector<T, RandomAccessContainer<SoARandomAccessContainer<T, VectorBinder<Allocator>::template type, Tracking, TransposedLayout>>>;
+
+// Unsigned integers of 'bits' width packed into 64-bit words
+class BitPackedVector
+{
+public:
+    BitPackedVector() = default;
+    BitPackedVector(size_t size, unsigned bits) : width(bits), words(size * bits / 64 + 2, 0) { }
+
+    uint64_t operator[](size_t index) const noexcept { return extract(index * width); }
+
+    // Sequential unpacking: aligned groups of 64 values occupy exactly 'width' words
+    // and are unpacked by kernels with constant shifts, the rest is extracted one by one.
+    // Codes are unpacked to 32-bit integers if the width is at most 32.
+    template<typename Code>
+    void unpack(size_t first, size_t size, Code* out) const noexcept
+    {
+        static_assert(std::is_same_v<Code, uint32_t> || std::is_same_v<Code, uint64_t>);
+        assert(width <= sizeof(Code) * 8);
+        size_t i = 0;
+        if (first % 64 == 0) {
+            const auto kernel = group_kernels<Code>(std::make_integer_sequence<unsigned, sizeof(Code) * 8 + 1>{})[width];
+            for (; i + 64 <= size; i += 64)
+                kernel(words.data() + (first + i) / 64 * width, out + i);
+        }
+        for (size_t bit = (first + i) * width; i < size; ++i, bit += width)
+            out[i] = Code(extract(bit));
+    }
+
+    void set(size_t index, uint64_t value) noexcept
+    {
+        if (width == 0)
+            return;
+        const size_t bit = index * width;
+        const size_t word = bit / 64;
+        const unsigned shift = bit % 64;
+        words[word] |= value << shift;
+        if (shift + width > 64)
+            words[word + 1] |= value >> (64 - shift);
+    }
+
+    unsigned bits() const noexcept { return width; }
+    size_t memory_usage() const noexcept { return words.size() * sizeof(uint64_t); }
+
+    static unsigned bit_width(uint64_t value) noexcept
+    {
+        unsigned result = 0;
+        while (result < 64 && (value >> result) != 0)
+            ++result;
+        return result;
+    }
+
+private:
+    template<typename Code>
+    using GroupKernel = void (*)(const uint64_t*, Code*);
+
+    template<unsigned W, unsigned I, typename Code>
+    static void unpack_value(const uint64_t* in, Code* out) noexcept
+    {
+        constexpr unsigned word = I * W / 64;
+        constexpr unsigned shift = I * W % 64;
+        constexpr uint64_t mask = W == 64 ? ~uint64_t{} : (uint64_t{1} << W) - 1;
+        if constexpr (shift + W > 64)
+            out[I] = Code(((in[word] >> shift) | (in[word + 1] << (64 - shift))) & mask);
+        else
+            out[I] = Code((in[word] >> shift) & mask);
+    }
+
+    template<unsigned W, typename Code, unsigned ... I>
+    static void unpack_group(const uint64_t* in, Code* out, std::integer_sequence<unsigned, I...>) noexcept
+    {
+        (unpack_value<W, I>(in, out), ...);
+    }
+
+    template<unsigned W, typename Code>
+    static void unpack_group(const uint64_t* in, Code* out) noexcept
+    {
+#if defined(__AVX2__)
+        const auto* bytes = reinterpret_cast<const char*>(in);
+        if constexpr (std::is_same_v<Code, uint32_t> && W > 0 && W <= 25) {
+            for (unsigned k = 0; k < 64; k += 8)
+                _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + k), unpack_octet<W>(bytes + k * W / 8));
+            return;
+        }
+        else if constexpr (std::is_same_v<Code, uint32_t> && W > 25) {
+            // Even halves of 64-bit lanes are gathered to the low 128 bits
+            const __m256i even = _mm256_setr_epi32(0, 2, 4, 6, 0, 0, 0, 0);
+            for (unsigned k = 0; k < 64; k += 8) {
+                const __m256i low = _mm256_permutevar8x32_epi32(unpack_quad<W, 0>(bytes + k * W / 8), even);
+                const __m256i high = _mm256_permutevar8x32_epi32(unpack_quad<W, 4>(bytes + k * W / 8), even);
+                _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + k), _mm256_permute2x128_si256(low, high, 0x20));
+            }
+            return;
+        }
+        else if constexpr (W > 0 && W <= 56) {
+            for (unsigned k = 0; k < 64; k += 8) {
+                _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + k), unpack_quad<W, 0>(bytes + k * W / 8));
+                _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + k + 4), unpack_quad<W, 4>(bytes + k * W / 8));
+            }
+            return;
+        }
+#endif
+        unpack_group<W>(in, out, std::make_integer_sequence<unsigned, 64>{});
+    }
+
+    template<typename Code, unsigned ... W>
+    static constexpr std::array<GroupKernel<Code>, sizeof...(W)> group_kernels(std::integer_sequence<unsigned, W...>) noexcept
+    {
+        return { &unpack_group<W, Code>... };
+    }
+
+#if defined(__AVX2__)
+    // 8 values occupy exactly W bytes, so octets start at byte boundaries. Each 128-bit lane
+    // is loaded from the first byte of a run of values, then bytes of the values are shuffled
+    // to their lanes and shifted in place. Loads read less than 16 bytes past the octet,
+    // which are covered by the padding words at the end.
+
+    // Offset of value K of an octet from the first byte of its run of N values
+    template<unsigned W, unsigned N, unsigned K>
+    static constexpr unsigned run_bit = K * W - K / N * N * W / 8 * 8;
+
+    template<unsigned W, unsigned N, unsigned K, unsigned ... I>
+    static __m256i run_shuffle(std::integer_sequence<unsigned, I...>) noexcept
+    {
+        constexpr unsigned lane = 32 / (2 * N);
+        return _mm256_setr_epi8(char(run_bit<W, N, K + I / lane> / 8 + I % lane)...);
+    }
+
+    static __m256i load_runs(const char* low, const char* high) noexcept
+    {
+        const __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i*>(low));
+        const __m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i*>(high));
+        return _mm256_inserti128_si256(_mm256_castsi128_si256(a), b, 1);
+    }
+
+    // Values of up to 25 bits span at most 4 bytes, the octet is unpacked to 32-bit lanes
+    template<unsigned W>
+    static __m256i unpack_octet(const char* in) noexcept
+    {
+        const __m256i lanes = _mm256_shuffle_epi8(load_runs(in, in + 4 * W / 8), run_shuffle<W, 4, 0>(std::make_integer_sequence<unsigned, 32>{}));
+        const __m256i shifts = _mm256_setr_epi32(run_bit<W, 4, 0> % 8, run_bit<W, 4, 1> % 8, run_bit<W, 4, 2> % 8, run_bit<W, 4, 3> % 8,
+            run_bit<W, 4, 4> % 8, run_bit<W, 4, 5> % 8, run_bit<W, 4, 6> % 8, run_bit<W, 4, 7> % 8);
+        return _mm256_and_si256(_mm256_srlv_epi32(lanes, shifts), _mm256_set1_epi32(int32_t((uint32_t{1} << W) - 1)));
+    }
+
+    // Values of up to 56 bits span at most 8 bytes, values K..K+3 of the octet are unpacked to 64-bit lanes
+    template<unsigned W, unsigned K>
+    static __m256i unpack_quad(const char* in) noexcept
+    {
+        const __m256i lanes = _mm256_shuffle_epi8(load_runs(in + K * W / 8, in + (K + 2) * W / 8), run_shuffle<W, 2, K>(std::make_integer_sequence<unsigned, 32>{}));
+        const __m256i shifts = _mm256_setr_epi64x(run_bit<W, 2, K> % 8, run_bit<W, 2, K + 1> % 8, run_bit<W, 2, K + 2> % 8, run_bit<W, 2, K + 3> % 8);
+        return _mm256_and_si256(_mm256_srlv_epi64(lanes, shifts), _mm256_set1_epi64x((int64_t{1} << W) - 1));
+    }
+#endif
+
+    uint64_t extract(size_t bit) const noexcept
+    {
+        const size_t word = bit / 64;
+        const unsigned shift = bit % 64;
+        const uint64_t mask = width == 64 ? ~uint64_t{} : (uint64_t{1} << width) - 1;
+        return ((words[word] >> shift) | ((words[word + 1] << 1) << (63 - shift))) & mask;
+    }
+
+    unsigned width = 0;
+    std::vector<uint64_t> words;
+};
+
+// Encodings of frozen columns:
+// - plain: raw values;
+// - dictionary: bit-packed codes of sorted distinct values;
+// - frame_of_reference: bit-packed offsets from the minimum;
+// - delta: bit-packed differences of non-decreasing values with absolute checkpoints per block.
+enum class Encoding { plain, dictionary, frame_of_reference, delta };
+
+// Read-only column which is encoded by the most compact encoding at construction.
+// Only integral and enumeration types are encoded, other types are always plain.
+template<typename U>
+class EncodedColumn
+{
+    static constexpr bool encodable = (std::is_integral_v<U> || std::is_enum_v<U>) && !std::is_same_v<U, bool>;
+    static constexpr bool ordered = encodable || std::is_floating_point_v<U>;
+public:
+    static constexpr size_t block_size = 256;
+
+    EncodedColumn() = default;
+    explicit EncodedColumn(std::vector<U> values)
+    {
+        const Encoding e = choose(values);
+        encode(std::move(values), e);
+    }
+    EncodedColumn(std::vector<U> values, Encoding e) { encode(std::move(values), e); }
+
+    size_t size() const noexcept { return count; }
+    Encoding encoding() const noexcept { return scheme; }
+
+    size_t memory_usage() const noexcept
+    {
+        return dictionary.size() * sizeof(U) + codes.memory_usage() + checkpoints.size() * sizeof(uint64_t);
+    }
+
+    U operator[](size_t index) const noexcept
+    {
+        switch (scheme) {
+        case Encoding::dictionary:
+            return dictionary[codes[index]];
+        case Encoding::frame_of_reference:
+            return from_bits(base + codes[index]);
+        case Encoding::delta: {
+            const size_t block = index / block_size;
+            uint64_t value = checkpoints[block];
+            for (size_t i = block * block_size + 1; i <= index; ++i)
+                value += codes[i];
+            return from_bits(value);
+        }
+        default:
+            return dictionary[index];
+        }
+    }
+
+    // Decodes values [first, first + size) to 'out'
+    void decode(size_t first, size_t size, U* out) const noexcept
+    {
+        if (scheme == Encoding::plain) {
+            std::copy(dictionary.begin() + first, dictionary.begin() + first + size, out);
+            return;
+        }
+        for_each_code_block(first, size, [&](const auto* unpacked, size_t offset, size_t length) {
+            decode_block(offset, length, unpacked, out + (offset - first));
+        });
+    }
+
+    // Calls f(values, first, size) for blocks of decoded values. Plain columns are not copied.
+    template<typename F>
+    void for_each_block(F f) const
+    {
+        if (scheme == Encoding::plain) {
+            if (count > 0)
+                f(dictionary.data(), size_t{0}, count);
+            return;
+        }
+        std::array<U, block_size> buffer;
+        for_each_code_block(0, count, [&](const auto* unpacked, size_t first, size_t size) {
+            decode_block(first, size, unpacked, buffer.data());
+            f(static_cast<const U*>(buffer.data()), first, size);
+        });
+    }
+
+    std::pair<U, U> minmax() const noexcept { return { min, max }; }
+
+    size_t count_of(const U& value) const noexcept
+    {
+        if (count == 0 || out_of_range(value))
+            return 0;
+        if constexpr (encodable) {
+            if (scheme == Encoding::dictionary || scheme == Encoding::frame_of_reference) {
+                const uint64_t code = encoded_value(value);
+                if (missing(code))
+                    return 0;
+                size_t result = 0;
+                for_each_code_block(0, count, [&](const auto* unpacked, size_t, size_t size) {
+                    result += kernels::count(as_lanes(unpacked), size, as_lane(unpacked, code));
+                });
+                return result;
+            }
+        }
+        size_t result = 0;
+        for_each_block([&](const U* data, size_t, size_t size) { result += kernels::count(data, size, value); });
+        return result;
+    }
+
+    size_t find(const U& value) const noexcept
+    {
+        if (count == 0 || out_of_range(value))
+            return count;
+        if constexpr (encodable) {
+            if (scheme == Encoding::dictionary || scheme == Encoding::frame_of_reference) {
+                const uint64_t code = encoded_value(value);
+                if (missing(code))
+                    return count;
+                size_t result = count;
+                for_each_code_block(0, count, [&](const auto* unpacked, size_t first, size_t size) {
+                    const size_t i = kernels::find(as_lanes(unpacked), size, as_lane(unpacked, code));
+                    if (i != size)
+                        result = first + i;
+                    return i == size;
+                });
+                return result;
+            }
+        }
+        size_t result = count;
+        for_each_block([&](const U* data, size_t first, size_t size) {
+            if (result == count) {
+                const size_t i = kernels::find(data, size, value);
+                if (i != size)
+                    result = first + i;
+            }
+        });
+        return result;
+    }
+
+    template<typename R>
+    R sum(R init) const noexcept
+    {
+        if (scheme == Encoding::dictionary) {
+            std::vector<size_t> histogram(dictionary.size(), 0);
+            for_each_code_block(0, count, [&](const auto* unpacked, size_t, size_t size) {
+                for (size_t i = 0; i < size; ++i)
+                    ++histogram[unpacked[i]];
+            });
+            for (size_t c = 0; c < dictionary.size(); ++c)
+                init += R(dictionary[c]) * R(histogram[c]);
+            return init;
+        }
+        if constexpr (std::is_integral_v<U>) {
+            // Offsets are summed without decoding: sum = count * min + sum of offsets
+            if (scheme == Encoding::frame_of_reference) {
+                uint64_t offsets = 0;
+                for_each_code_block(0, count, [&](const auto* unpacked, size_t, size_t size) {
+                    for (size_t i = 0; i < size; ++i)
+                        offsets += unpacked[i];
+                });
+                return init + R(min) * R(count) + R(offsets);
+            }
+            // A delta at position i of a block is a part of all following values of the block:
+            // sum = size * checkpoint + sum of (size - i) * delta[i], which needs no prefix sum
+            if (scheme == Encoding::delta && std::is_integral_v<R>) {
+                uint64_t total = 0;
+                for_each_code_block(0, count, [&](const auto* unpacked, size_t first, size_t size) {
+                    using Code = std::remove_const_t<std::remove_reference_t<decltype(*unpacked)>>;
+                    total += size * checkpoints[first / block_size];
+                    for (size_t i = 1; i < size; ++i)
+                        total += uint64_t(Code(size - i)) * unpacked[i];
+                });
+                return init + R(total);
+            }
+        }
+        for_each_block([&](const U* data, size_t, size_t size) { init = kernels::sum(data, size, init); });
+        return init;
+    }
+
+private:
+    static constexpr uint64_t npos = ~uint64_t{};
+
+    // Only dictionaries lack values in range, 64-bit offsets of frames of reference take all codes
+    bool missing(uint64_t code) const noexcept { return scheme == Encoding::dictionary && code == npos; }
+
+    // Codes are only compared for equality, so 32-bit codes are scanned by the SIMD kernels of int32_t.
+    // A code in range fits to the width of unpacked codes.
+    static const int32_t* as_lanes(const uint32_t* unpacked) noexcept { return reinterpret_cast<const int32_t*>(unpacked); }
+    static const uint64_t* as_lanes(const uint64_t* unpacked) noexcept { return unpacked; }
+
+    template<typename Code>
+    static auto as_lane(const Code* unpacked, uint64_t code) noexcept { return std::remove_cv_t<std::remove_pointer_t<decltype(as_lanes(unpacked))>>(code); }
+
+    // Calls f(codes, first, size) for blocks of codes of [first, first + size),
+    // which are unpacked to 32-bit integers if they fit, until f returns false
+    template<typename F>
+    void for_each_code_block(size_t first, size_t size, F f) const
+    {
+        if (codes.bits() <= 32)
+            unpack_blocks<uint32_t>(first, size, f);
+        else
+            unpack_blocks<uint64_t>(first, size, f);
+    }
+
+    template<typename Code, typename F>
+    void unpack_blocks(size_t first, size_t size, F& f) const
+    {
+        std::array<Code, block_size> unpacked;
+        for (size_t offset = 0; offset < size; offset += block_size) {
+            const size_t length = std::min(block_size, size - offset);
+            codes.unpack(first + offset, length, unpacked.data());
+            if constexpr (std::is_same_v<decltype(f(static_cast<const Code*>(unpacked.data()), first, length)), bool>) {
+                if (!f(static_cast<const Code*>(unpacked.data()), first + offset, length))
+                    return;
+            }
+            else {
+                f(static_cast<const Code*>(unpacked.data()), first + offset, length);
+            }
+        }
+    }
+
+    template<typename Code>
+    void decode_block(size_t first, size_t size, const Code* unpacked, U* out) const noexcept
+    {
+        switch (scheme) {
+        case Encoding::dictionary:
+            for (size_t i = 0; i < size; ++i)
+                out[i] = dictionary[unpacked[i]];
+            break;
+        case Encoding::frame_of_reference:
+            for (size_t i = 0; i < size; ++i)
+                out[i] = from_bits(base + unpacked[i]);
+            break;
+        default: {
+            // Deltas are stored at all positions, so decoding is a prefix sum from the first value
+            uint64_t value = first % block_size == 0 ? checkpoints[first / block_size] : to_bits((*this)[first]);
+            out[0] = from_bits(value);
+            for (size_t i = 1; i < size; ++i) {
+                value += unpacked[i];
+                out[i] = from_bits(value);
+            }
+        }
+        }
+    }
+
+    bool out_of_range(const U& value) const noexcept
+    {
+        if constexpr (ordered)
+            return value < min || max < value;
+        else
+            return false;
+    }
+
+    static uint64_t to_bits(U value) noexcept
+    {
+        if constexpr (encodable) {
+            using Underlying = typename std::conditional_t<std::is_enum_v<U>, std::underlying_type<U>, std::enable_if<true, U>>::type;
+            using Wide = std::conditional_t<std::is_signed_v<Underlying>, int64_t, uint64_t>;
+            return uint64_t(Wide(static_cast<Underlying>(value)));
+        }
+        else {
+            (void)value;
+            return 0;
+        }
+    }
+
+    static U from_bits(uint64_t value) noexcept
+    {
+        if constexpr (encodable) {
+            using Underlying = typename std::conditional_t<std::is_enum_v<U>, std::underlying_type<U>, std::enable_if<true, U>>::type;
+            return static_cast<U>(static_cast<Underlying>(value));
+        }
+        else {
+            (void)value;
+            return U{};
+        }
+    }
+
+    uint64_t encoded_value(const U& value) const noexcept
+    {
+        if (scheme == Encoding::frame_of_reference)
+            return to_bits(value) - base;
+        const auto it = std::lower_bound(dictionary.begin(), dictionary.end(), value);
+        return it != dictionary.end() && *it == value ? uint64_t(it - dictionary.begin()) : npos;
+    }
+
+    static bool is_sorted(const std::vector<U>& values)
+    {
+        return std::is_sorted(values.begin(), values.end());
+    }
+
+    // Picks the encoding with the smallest footprint, the plain one wins ties
+    static Encoding choose(const std::vector<U>& values)
+    {
+        if constexpr (!encodable) {
+            (void)values;
+            return Encoding::plain;
+        }
+        else {
+            if (values.empty())
+                return Encoding::plain;
+            const size_t n = values.size();
+            const auto [lo, hi] = std::minmax_element(values.begin(), values.end());
+            std::vector<std::pair<size_t, Encoding>> candidates;
+            candidates.emplace_back(n * sizeof(U), Encoding::plain);
+            candidates.emplace_back(n * BitPackedVector::bit_width(to_bits(*hi) - to_bits(*lo)) / 8, Encoding::frame_of_reference);
+
+            std::vector<U> distinct(values);
+            std::sort(distinct.begin(), distinct.end());
+            distinct.erase(std::unique(distinct.begin(), distinct.end()), distinct.end());
+            candidates.emplace_back(distinct.size() * sizeof(U) + n * BitPackedVector::bit_width(distinct.size() - 1) / 8, Encoding::dictionary);
+
+            if (is_sorted(values)) {
+                uint64_t max_delta = 0;
+                for (size_t i = 1; i < n; ++i)
+                    max_delta = std::max(max_delta, to_bits(values[i]) - to_bits(values[i - 1]));
+                candidates.emplace_back(n * BitPackedVector::bit_width(max_delta) / 8 + (n / block_size + 1) * sizeof(uint64_t), Encoding::delta);
+            }
+            return std::min_element(candidates.begin(), candidates.end(), [](const auto& a, const auto& b) { return a.first < b.first; })->second;
+        }
+    }
+
+    void encode(std::vector<U> values, Encoding e)
+    {
+        count = values.size();
+        scheme = encodable ? e : Encoding::plain;
+        if constexpr (ordered) {
+            // Same NaN handling as the scan kernels of plain columns
+            if (count > 0)
+                std::tie(min, max) = kernels::minmax(static_cast<const U*>(values.data()), count);
+        }
+        if constexpr (encodable) {
+            switch (scheme) {
+            case Encoding::dictionary: {
+                dictionary = values;
+                std::sort(dictionary.begin(), dictionary.end());
+                dictionary.erase(std::unique(dictionary.begin(), dictionary.end()), dictionary.end());
+                dictionary.shrink_to_fit();
+                codes = BitPackedVector(count, BitPackedVector::bit_width(dictionary.size() - 1));
+                for (size_t i = 0; i < count; ++i)
+                    codes.set(i, encoded_value(values[i]));
+                return;
+            }
+            case Encoding::frame_of_reference:
+                base = to_bits(min);
+                codes = BitPackedVector(count, BitPackedVector::bit_width(to_bits(max) - base));
+                for (size_t i = 0; i < count; ++i)
+                    codes.set(i, to_bits(values[i]) - base);
+                return;
+            case Encoding::delta: {
+                if (!is_sorted(values))
+                    throw std::invalid_argument("Delta encoding requires non-decreasing values");
+                uint64_t max_delta = 0;
+                for (size_t i = 1; i < count; ++i)
+                    max_delta = std::max(max_delta, to_bits(values[i]) - to_bits(values[i - 1]));
+                codes = BitPackedVector(count, BitPackedVector::bit_width(max_delta));
+                for (size_t i = 0; i < count; ++i) {
+                    if (i % block_size == 0)
+                        checkpoints.push_back(to_bits(values[i]));
+                    if (i > 0)
+                        codes.set(i, to_bits(values[i]) - to_bits(values[i - 1]));
+                }
+                return;
+            }
+            default:
+                break;
+            }
+        }
+        dictionary = std::move(values);
+        dictionary.shrink_to_fit();
+    }
+
+    Encoding scheme = Encoding::plain;
+    size_t count = 0;
+    U min{};
+    U max{};
+    uint64_t base = 0;
+    std::vector<U> dictionary; // raw values of plain columns
+    BitPackedVector codes;
+    std::vector<uint64_t> checkpoints;
+};
+
+// Immutable SoA table with encoded columns, which is produced by freeze() of vectors.
+// Elements are decoded on access, and column algorithms work on codes or decoded blocks.
+template<typename T>
+class FrozenSoAVector : Traits<T>
+{
+    template<typename ... TT>
+    static constexpr std::tuple<EncodedColumn<TT>...> tupilzer(TypeList<TT...>);
+
+    using Storage = decltype(tupilzer(typename LeafFields<T, ShallowLayout, true>::type{}));
+    using Indices = std::make_index_sequence<boost::pfr::tuple_size_v<T>>;
+
+public:
+    using value_type = T;
+
+    FrozenSoAVector() = default;
+
+    // Copies elements of any container, which provides size() and operator[] convertible to T
+    template<typename Container>
+    explicit FrozenSoAVector(const Container& source) : FrozenSoAVector(source, Indices{}) { }
+
+    size_t size() const noexcept { return std::get<0>(storage).size(); }
+    bool empty() const noexcept { return size() == 0; }
+
+    T operator[](size_t index) const noexcept { return aggregate(index, Indices{}); }
+
+    T at(size_t index) const
+    {
+        if (index >= size())
+            throw std::out_of_range("Frozen SoA container is out of range");
+        return operator[](index);
+    }
+
+    template<auto field>
+    auto get(size_t index) const noexcept { return get_column(field)[index]; }
+
+    template<auto field>
+    Encoding encoding() const noexcept { return get_column(field).encoding(); }
+
+    // Re-encodes the field with the specified encoding
+    template<auto field>
+    void encode(Encoding e)
+    {
+        auto& column = get_column(field);
+        std::vector<MemberType<field>> values(size());
+        column.decode(0, values.size(), values.data());
+        column = std::decay_t<decltype(column)>(std::move(values), e);
+    }
+
+    size_t memory_usage() const noexcept
+    {
+        return std::apply([](const auto& ... column) { return (size_t{0} + ... + column.memory_usage()); }, storage);
+    }
+
+    // Calls f(values, first, size) for blocks of decoded values of the field
+    template<auto field, typename F>
+    void for_each_block(F f) const { get_column(field).for_each_block(f); }
+
+    template<auto field>
+    size_t find(const MemberType<field>& value) const { return get_column(field).find(value); }
+
+    template<auto field>
+    size_t count(const MemberType<field>& value) const { return get_column(field).count_of(value); }
+
+    template<auto field>
+    auto minmax() const { assert(!empty()); return get_column(field).minmax(); }
+
+    template<auto field>
+    auto min() const { return minmax<field>().first; }
+
+    template<auto field>
+    auto max() const { return minmax<field>().second; }
+
+    template<auto field, typename U = SumType<MemberType<field>>>
+    U sum(U init = U{}) const { return get_column(field).sum(init); }
+
+private:
+    template<typename Container, size_t ... N>
+    FrozenSoAVector(const Container& source, std::index_sequence<N...>)
+    {
+        std::tuple<std::vector<std::remove_cv_t<boost::pfr::tuple_element_t<N, T>>>...> columns;
+        (std::get<N>(columns).reserve(source.size()), ...);
+        for (size_t i = 0; i < source.size(); ++i) {
+            const T value = source[i];
+            (std::get<N>(columns).push_back(boost::pfr::get<N>(value)), ...);
+        }
+        ((std::get<N>(storage) = std::tuple_element_t<N, Storage>(std::move(std::get<N>(columns)))), ...);
+    }
+
+    template<size_t ... N>
+    T aggregate(size_t index, std::index_sequence<N...>) const noexcept
+    {
+        T result{};
+        ((void)(boost::pfr::get<N>(result) = std::get<N>(storage)[index]), ...);
+        return result;
+    }
+
+    template<typename R>
+    auto& get_column(R T::* member) const noexcept { return *get_column_impl<boost::pfr::tuple_size_v<T>>(member); }
+
+    template<typename R>
+    auto& get_column(R T::* member) noexcept { return const_cast<EncodedColumn<std::remove_cv_t<R>>&>(std::as_const(*this).get_column(member)); }
+
+    template<size_t I, typename R>
+    const EncodedColumn<std::remove_cv_t<R>>* get_column_impl(R T::* member) const noexcept
+    {
+        if constexpr (I == 0)
+            return nullptr;
+        else if constexpr (!std::is_same_v<std::remove_cv_t<boost::pfr::tuple_element_t<I - 1, T>>, std::remove_cv_t<R>>)
+            return get_column_impl<I - 1>(member);
+        else if (this->member_to_index(member) == I - 1)
+            return &std::get<I - 1>(storage);
+        else
+            return get_column_impl<I - 1>(member);
+    }
+
+    Storage storage;
+};
+
+// Column which grows by appending chunks of ChunkSize elements, like a deque.
+// Elements are never moved on growth, and reserve() only allocates chunks in advance.
+template<typename U, size_t ChunkSize>
+class ChunkedColumn
+{
+    static_assert(ChunkSize > 0 && (ChunkSize & (ChunkSize - 1)) == 0, "Chunk size must be a power of two");
+    using Chunk = std::vector<U>;
+public:
+    static constexpr size_t chunk_size = ChunkSize;
+
+    auto size() const noexcept { return count; }
+    bool empty() const noexcept { return count == 0; }
+    auto capacity() const noexcept { return chunks.size() * ChunkSize; }
+
+    U& operator[](size_t index) noexcept { return chunks[index / ChunkSize][index % ChunkSize]; }
+    const U& operator[](size_t index) const noexcept { return chunks[index / ChunkSize][index % ChunkSize]; }
+    const U* chunk(size_t index) const noexcept { return chunks[index].data(); }
+
+    void reserve(size_t s)
+    {
+        while (capacity() < s) {
+            chunks.emplace_back();
+            chunks.back().reserve(ChunkSize);
+        }
+    }
+
+    void shrink_to_fit()
+    {
+        chunks.resize((count + ChunkSize - 1) / ChunkSize);
+        chunks.shrink_to_fit();
+    }
+
+    void resize(size_t s) { resize_chunks(s, [](Chunk& chunk, size_t n) { chunk.resize(n); }); }
+    void resize(size_t s, const U& value) { resize_chunks(s, [&](Chunk& chunk, size_t n) { chunk.resize(n, value); }); }
+    void assign(size_t s, const U& value) { resize(0); resize(s, value); }
+
+    void push_back(const U& value) { reserve(count + 1); chunks[count / ChunkSize].push_back(value); ++count; }
+    void push_back(U&& value) { reserve(count + 1); chunks[count / ChunkSize].push_back(std::move(value)); ++count; }
+
+private:
+    // Only the chunks between the old and the new size change, chunks never exceed their capacity
+    template<typename F>
+    void resize_chunks(size_t s, F resize_chunk)
+    {
+        reserve(s);
+        const size_t first = std::min(count, s) / ChunkSize;
+        const size_t last = (std::max(count, s) + ChunkSize - 1) / ChunkSize;
+        for (size_t b = first; b < last; ++b)
+            resize_chunk(chunks[b], s > b * ChunkSize ? std::min(ChunkSize, s - b * ChunkSize) : 0);
+        count = s;
+    }
+
+    std::vector<Chunk> chunks;
+    size_t count = 0;
+};
+
+template<size_t ChunkSize>
+struct ChunkedBinder
+{
+    template<typename T> using type = ChunkedColumn<T, ChunkSize>;
+};
+
+template<typename T, size_t ChunkSize = 4096, typename Tracking = NoTracking>
+using SegmentedAoSVector = BaseAoSVector<T, RandomAccessContainer<AoSRandomAccessContainer<T, ChunkedBinder<ChunkSize>::template type, Tracking>>>;
+
+template<typename T, size_t ChunkSize = 4096, typename Tracking = NoTracking>
+using SegmentedSoAVector = BaseSoAVector<T, RandomAccessContainer<SoARandomAccessContainer<T, ChunkedBinder<ChunkSize>::template type, Tracking>>>;
+
+// Column which keeps up to InlineN elements inside the object and spills to the heap beyond that.
+// Elements remain contiguous in both cases.
+template<typename U, size_t InlineN>
+class SmallColumn
+{
+    static_assert(InlineN > 0, "Inline capacity must be positive");
+public:
+    SmallColumn() = default;
+    SmallColumn(const SmallColumn&) = default;
+    SmallColumn& operator=(const SmallColumn&) = default;
+
+    SmallColumn(SmallColumn&& rhs) noexcept
+        : local(std::move(rhs.local))
+        , heap(std::move(rhs.heap))
+        , count(std::exchange(rhs.count, 0))
+        , on_heap(std::exchange(rhs.on_heap, false))
+    { }
+
+    SmallColumn& operator=(SmallColumn&& rhs) noexcept
+    {
+        local = std::move(rhs.local);
+        heap = std::move(rhs.heap);
+        count = std::exchange(rhs.count, 0);
+        on_heap = std::exchange(rhs.on_heap, false);
+        return *this;
+    }
+
+    auto size() const noexcept { return count; }
+    bool empty() const noexcept { return count == 0; }
+    auto capacity() const noexcept { return on_heap ? heap.capacity() : InlineN; }
+
+    U* data() noexcept { return on_heap ? heap.data() : local.data(); }
+    const U* data() const noexcept { return on_heap ? heap.data() : local.data(); }
+    U& operator[](size_t index) noexcept { return data()[index]; }
+    const U& operator[](size_t index) const noexcept { return data()[index]; }
+
+    void reserve(size_t s)
+    {
+        if (s > capacity())
+            spill(s);
+    }
+
+    // Moves elements back inside the object if they fit
+    void shrink_to_fit()
+    {
+        if (!on_heap)
+            return;
+        if (count > InlineN) {
+            heap.shrink_to_fit();
+            return;
+        }
+        std::move(heap.begin(), heap.end(), local.begin());
+        heap = std::vector<U>();
+        on_heap = false;
+    }
+
+    void resize(size_t s)
+    {
+        if (!on_heap && s <= InlineN) {
+            reset(std::min(count, s), std::max(count, s));
+        }
+        else {
+            reserve(s);
+            heap.resize(s);
+        }
+        count = s;
+    }
+
+    void resize(size_t s, const U& value)
+    {
+        if (!on_heap && s <= InlineN) {
+            reset(s, count);
+            std::fill(local.begin() + std::min(count, s), local.begin() + s, value);
+        }
+        else {
+            reserve(s);
+            heap.resize(s, value);
+        }
+        count = s;
+    }
+
+    void assign(size_t s, const U& value) { resize(0); resize(s, value); }
+
+    void push_back(const U& value)
+    {
+        if (count == capacity())
+            reserve(2 * count);
+        if (on_heap)
+            heap.push_back(value);
+        else
+            local[count] = value;
+        ++count;
+    }
+
+    void push_back(U&& value)
+    {
+        if (count == capacity())
+            reserve(2 * count);
+        if (on_heap)
+            heap.push_back(std::move(value));
+        else
+            local[count] = std::move(value);
+        ++count;
+    }
+
+private:
+    void spill(size_t s)
+    {
+        if (on_heap) {
+            heap.reserve(s);
+            return;
+        }
+        heap.reserve(s);
+        heap.insert(heap.end(), std::make_move_iterator(local.begin()), std::make_move_iterator(local.begin() + count));
+        reset(0, count);
+        on_heap = true;
+    }
+
+    // Inline elements out of the size are kept value-initialized, so they do not hold resources
+    void reset(size_t first, size_t last)
+    {
+        for (size_t i = first; i < last; ++i)
+            local[i] = U{};
+    }
+
+    std::array<U, InlineN> local{};
+    std::vector<U> heap;
+    size_t count = 0;
+    bool on_heap = false;
+};
+
+template<size_t InlineN>
+struct SmallBinder
+{
+    template<typename T> using type = SmallColumn<T, InlineN>;
+};
+
+template<typename T, size_t InlineN, typename Tracking = NoTracking>
+using SmallAoSVector = BaseAoSVector<T, RandomAccessContainer<AoSRandomAccessContainer<T, SmallBinder<InlineN>::template type, Tracking>>>;
+
+template<typename T, size_t InlineN, typename Tracking = NoTracking>
+using SmallSoAVector = BaseSoAVector<T, RandomAccessContainer<SoARandomAccessContainer<T, SmallBinder<InlineN>::template type, Tracking>>>;
+
+// Column which shares its storage with its copies until it is written.
+// With BlockSize = 0 the whole column is shared, otherwise it is split to blocks
+// of BlockSize elements, and only the written blocks are copied.
+// Element access never detaches: containers call 'detach' before writes.
+template<typename U, size_t BlockSize = 0>
+class CowColumn
+{
+    using Block = std::vector<U>;
+    static constexpr bool whole = BlockSize == 0;
+public:
+    auto size() const noexcept { return count; }
+    bool empty() const noexcept { return count == 0; }
+
+    auto capacity() const noexcept
+    {
+        if constexpr (whole)
+            return blocks.empty() ? size_t{0} : blocks[0]->capacity();
+        else
+            return blocks.capacity() * BlockSize;
+    }
+
+    // Shared pointers are not deep-const, so const columns may be written by mutable fields
+    U& operator[](size_t index) const noexcept
+    {
+        if constexpr (whole)
+            return (*blocks[0])[index];
+        else
+            return (*blocks[index / BlockSize])[index % BlockSize];
+    }
+
+    template<size_t B = BlockSize, typename = std::enable_if_t<B == 0>>
+    const U* data() const noexcept { return blocks.empty() ? nullptr : blocks[0]->data(); }
+
+    void detach(size_t first, size_t last)
+    {
+        if (first >= last)
+            return;
+        const size_t first_block = whole ? 0 : first / BlockSize;
+        const size_t last_block = whole ? 1 : (last - 1) / BlockSize + 1;
+        for (size_t b = first_block; b < std::min(last_block, blocks.size()); ++b)
+            unshare(b);
+    }
+
+    void resize(size_t s)
+    {
+        if constexpr (whole) {
+            if (blocks.empty())
+                blocks.push_back(std::make_shared<Block>());
+            unshare(0);
+            blocks[0]->resize(s);
+        }
+        else {
+            const size_t old_blocks = blocks.size();
+            const size_t new_blocks = (s + BlockSize - 1) / BlockSize;
+            blocks.resize(new_blocks);
+            // Only the last old block and the new ones change their size
+            for (size_t b = std::min(old_blocks, new_blocks) > 0 ? std::min(old_blocks, new_blocks) - 1 : 0; b < new_blocks; ++b) {
+                const size_t block_size = std::min(BlockSize, s - b * BlockSize);
+                if (blocks[b] == nullptr) {
+                    blocks[b] = std::make_shared<Block>();
+                    blocks[b]->reserve(BlockSize);
+                }
+                else if (blocks[b]->size() != block_size) {
+                    unshare(b);
+                }
+                blocks[b]->resize(block_size);
+            }
+        }
+        count = s;
+    }
+
+    void reserve(size_t s)
+    {
+        if constexpr (whole) {
+            if (blocks.empty())
+                blocks.push_back(std::make_shared<Block>());
+            if (s > blocks[0]->capacity()) {
+                unshare(0);
+                blocks[0]->reserve(s);
+            }
+        }
+        else {
+            blocks.reserve((s + BlockSize - 1) / BlockSize);
+        }
+    }
+
+    void shrink_to_fit()
+    {
+        if constexpr (whole) {
+            if (!blocks.empty() && blocks[0].use_count() == 1)
+                blocks[0]->shrink_to_fit();
+        }
+        else {
+            blocks.shrink_to_fit();
+        }
+    }
+
+private:
+    void unshare(size_t b)
+    {
+        if (blocks[b].use_count() > 1)
+            blocks[b] = std::make_shared<Block>(*blocks[b]);
+        else // the last copy could be released by another thread
+            std::atomic_thread_fence(std::memory_order_acquire);
+    }
+
+    std::vector<std::shared_ptr<Block>> blocks;
+    size_t count = 0;
+};
+
+template<size_t BlockSize>
+struct CowBinder
+{
+    template<typename T> using type = CowColumn<T, BlockSize>;
+};
+
+// SoA vector with copy-on-write columns. Copies and snapshots share the columns
+// until either side writes them, so they cost O(columns) or O(blocks).
+template<typename T, size_t BlockSize = 0, typename Tracking = NoTracking>
+class CowSoAVector : public BaseSoAVector<T, RandomAccessContainer<SoARandomAccessContainer<T, CowBinder<BlockSize>::template type, Tracking>>>
+{
+    using Base = BaseSoAVector<T, RandomAccessContainer<SoARandomAccessContainer<T, CowBinder<BlockSize>::template type, Tracking>>>;
+public:
+    using Base::Base;
+
+    // Immutable view, which may be passed to other threads while this vector is modified
+    std::shared_ptr<const CowSoAVector> snapshot() const { return std::make_shared<const CowSoAVector>(*this); }
+};
+
+// Dense storage of elements addressed by stable generational handles.
+// Handles resolve to dense indices through an indirection array of slots;
+// erase moves the last element to the hole, so elements remain dense and iteration
+// and column algorithms run over a plain vector.
+template<typename T, typename Vector>
+class BaseSlotMap
+{
+public:
+    struct Handle
+    {
+        uint32_t slot;
+        uint32_t generation;
+
+        bool operator==(const Handle& rhs) const noexcept { return slot == rhs.slot && generation == rhs.generation; }
+        bool operator!=(const Handle& rhs) const noexcept { return !(*this == rhs); }
+    };
+
+    static const constexpr size_t npos = size_t(-1);
+
+    auto size() const noexcept { return data.size(); }
+    bool empty() const noexcept { return data.empty(); }
+
+    Handle insert(const T& value) { data.push_back(value); return bind_last(); }
+    Handle insert(T&& value) { data.push_back(std::move(value)); return bind_last(); }
+
+    // Returns false if the handle is stale
+    bool erase(Handle handle)
+    {
+        const size_t index = index_of(handle);
+        if (index == npos)
+            return false;
+
+        const size_t last = data.size() - 1;
+        if (index != last) {
+            data[index] = data[last].aggregate_move();
+            dense_to_slot[index] = dense_to_slot[last];
+            slots[dense_to_slot[index]].dense = uint32_t(index);
+        }
+        data.pop_back();
+        dense_to_slot.pop_back();
+
+        auto& slot = slots[handle.slot];
+        ++slot.generation;
+        slot.dense = free_head;
+        free_head = handle.slot;
+        return true;
+    }
+
+    void clear()
+    {
+        while (!data.empty())
+            erase(handle(data.size() - 1));
+    }
+
+    // Dense index of the element, or npos if the handle is stale
+    size_t index_of(Handle handle) const noexcept
+    {
+        if (handle.slot >= slots.size() || slots[handle.slot].generation != handle.generation || !is_occupied(handle.generation))
+            return npos;
+        return slots[handle.slot].dense;
+    }
+
+    bool contains(Handle handle) const noexcept { return index_of(handle) != npos; }
+
+    // Handle of the element at the dense index
+    Handle handle(size_t index) const noexcept
+    {
+        const uint32_t slot = dense_to_slot[index];
+        return Handle{ slot, slots[slot].generation };
+    }
+
+    auto operator[](Handle handle) noexcept { assert(contains(handle)); return data[index_of(handle)]; }
+    auto operator[](Handle handle) const noexcept { assert(contains(handle)); return data[index_of(handle)]; }
+
+    auto at(Handle handle) { check_handle(handle); return data[index_of(handle)]; }
+    auto at(Handle handle) const { check_handle(handle); return data[index_of(handle)]; }
+
+    // Dense elements in unspecified order
+    auto begin() noexcept { return data.begin(); }
+    auto end() noexcept { return data.end(); }
+    auto begin() const noexcept { return data.begin(); }
+    auto end() const noexcept { return data.end(); }
+
+    // Read-only access to the dense vector, e.g. for column algorithms
+    const Vector& dense() const noexcept { return data; }
+
+private:
+    struct Slot
+    {
+        uint32_t dense;      // or the next free slot
+        uint32_t generation;
+    };
+
+    static const constexpr uint32_t no_slot = uint32_t(-1);
+
+    // Generations are odd while slots are occupied and even while they are free
+    static bool is_occupied(uint32_t generation) noexcept { return (generation & 1) != 0; }
+
+    Handle bind_last()
+    {
+        uint32_t slot = free_head;
+        if (slot == no_slot) {
+            slot = uint32_t(slots.size());
+            slots.push_back(Slot{ 0, 0 });
+        }
+        else {
+            free_head = slots[slot].dense;
+        }
+        slots[slot].dense = uint32_t(data.size() - 1);
+        ++slots[slot].generation;
+        dense_to_slot.push_back(slot);
+        return Handle{ slot, slots[slot].generation };
+    }
+
+    void check_handle(Handle handle) const
+    {
+        if (!contains(handle))
+            throw std::out_of_range("Slot map handle is stale");
+    }
+
+    Vector data;
+    std::vector<uint32_t> dense_to_slot;
+    std::vector<Slot> slots;
+    uint32_t free_head = no_slot;
+};
+
+template<typename T>
+using AoSSlotMap = BaseSlotMap<T, AoSVector<T>>;
+
+template<typename T>
+using SoASlotMap = BaseSlotMap<T, SoAVector<T>>;
+
+// Non-owning view of a contiguous part of a column
+template<typename U>
+class ColumnSpan
+{
+public:
+    constexpr ColumnSpan() noexcept = default;
+    constexpr ColumnSpan(U* data, size_t size) noexcept : ptr(data), count(size) { }
+
+    constexpr U* data() const noexcept { return ptr; }
+    constexpr size_t size() const noexcept { return count; }
+    constexpr bool empty() const noexcept { return count == 0; }
+    constexpr U& operator[](size_t index) const noexcept { return ptr[index]; }
+    constexpr U* begin() const noexcept { return ptr; }
+    constexpr U* end() const noexcept { return ptr + count; }
+
+private:
+    U* ptr = nullptr;
+    size_t count = 0;
+};
+
+template<size_t N>
+struct CacheAlignedBinder
+{
+    template<typename T> struct alignas(64) type : std::array<T, N> { };
+};
+
+// Producer policies of ring buffers
+struct SingleProducer
+{
+    static constexpr bool multiple = false;
+};
+
+struct MultipleProducers
+{
+    static constexpr bool multiple = true;
+};
+
+// Lock-free bounded queue with SoA layout for a single consumer.
+// Columns and cursors are aligned to cache lines, so producers and the consumer never share them.
+// With a single producer, cursors are published directly; with multiple producers,
+// slots are reserved by CAS on the tail and published by per-slot sequence numbers.
+template<typename T, size_t Capacity, typename Producers = SingleProducer>
+class SoARingBuffer : RandomAccessContainer<SoARandomAccessContainer<T, CacheAlignedBinder<Capacity>::template type>>
+{
+    static_assert(Capacity > 0 && (Capacity & (Capacity - 1)) == 0, "Capacity must be a power of two");
+    using Base = RandomAccessContainer<SoARandomAccessContainer<T, CacheAlignedBinder<Capacity>::template type>>;
+    using Indices = std::make_index_sequence<boost::pfr::tuple_size_v<T>>;
+    static constexpr size_t mask = Capacity - 1;
+
+public:
+    // Contiguous readable region, which is valid until it is consumed
+    class ConsumerView
+    {
+    public:
+        size_t size() const noexcept { return count; }
+        bool empty() const noexcept { return count == 0; }
+
+        template<auto field>
+        auto column() const noexcept { return ColumnSpan<const MemberType<field>>(ring->template column<field>().data() + first, count); }
+
+        auto operator[](size_t index) const noexcept { return static_cast<const Base&>(*ring)[first + index]; }
+
+    private:
+        friend class SoARingBuffer;
+        ConsumerView(const SoARingBuffer* r, size_t f, size_t c) noexcept : ring(r), first(f), count(c) { }
+
+        const SoARingBuffer* ring;
+        size_t first;
+        size_t count;
+    };
+
+    SoARingBuffer()
+    {
+        if constexpr (Producers::multiple)
+            for (size_t i = 0; i < Capacity; ++i)
+                sequence[i].store(i, std::memory_order_relaxed);
+    }
+
+    SoARingBuffer(const SoARingBuffer&) = delete;
+    SoARingBuffer& operator=(const SoARingBuffer&) = delete;
+
+    static constexpr size_t capacity() noexcept { return Capacity; }
+
+    // Approximate if called concurrently with producers or the consumer
+    size_t size() const noexcept
+    {
+        const size_t h = head.load(std::memory_order_acquire);
+        return tail.load(std::memory_order_acquire) - h;
+    }
+
+    bool empty() const noexcept { return size() == 0; }
+
+    // Producer interface, returns false if the buffer is full
+    bool push(const T& value) { return produce(1, [&](size_t position, size_t) { this->dissipate(value, position & mask); }) == 1; }
+    bool push(T&& value) { return produce(1, [&](size_t position, size_t) { this->dissipate_move(std::move(value), position & mask); }) == 1; }
+
+    // Pushes as many elements of the range as fit, column by column, and publishes them at once
+    template<typename It>
+    size_t push(It first, It last)
+    {
+        return produce(std::distance(first, last), [&](size_t position, size_t count) { scatter(first, position, count, Indices{}); });
+    }
+
+    // Consumer interface, returns false if the buffer is empty
+    bool pop(T& value)
+    {
+        return take(1, [&](size_t position, size_t) { value = this->aggregate_move(position & mask); }) == 1;
+    }
+
+    template<typename OutputIt>
+    size_t pop(OutputIt out, size_t max)
+    {
+        return take(max, [&](size_t position, size_t count) {
+            for (size_t i = 0; i < count; ++i)
+                *out++ = this->aggregate_move((position + i) & mask);
+        });
+    }
+
+    // Readable elements up to the end of the columns, which are released by 'consume'
+    ConsumerView peek() const noexcept
+    {
+        const size_t position = head.load(std::memory_order_relaxed);
+        return ConsumerView(this, position & mask, readable(position, Capacity - (position & mask)));
+    }
+
+    void consume(size_t count) noexcept
+    {
+        const size_t position = head.load(std::memory_order_relaxed);
+        assert(readable(position, count) == count);
+        release(position, count);
+    }
+
+private:
+    // Reserves up to 'wanted' slots, fills them with fill(position, count), and publishes them
+    template<typename F>
+    size_t produce(size_t wanted, F fill)
+    {
+        size_t position = tail.load(std::memory_order_relaxed);
+        size_t count = 0;
+        if constexpr (Producers::multiple) {
+            while (true) {
+                count = 0;
+                while (count < wanted && sequence[(position + count) & mask].load(std::memory_order_acquire) == position + count)
+                    ++count;
+                if (count == 0) {
+                    // The slot is either not consumed yet, or reserved by another producer
+                    if (ptrdiff_t(sequence[position & mask].load(std::memory_order_acquire) - position) < 0)
+                        return 0;
+                    position = tail.load(std::memory_order_relaxed);
+                    continue;
+                }
+                if (tail.compare_exchange_weak(position, position + count, std::memory_order_relaxed))
+                    break;
+            }
+            fill(position, count);
+            for (size_t i = 0; i < count; ++i)
+                sequence[(position + i) & mask].store(position + i + 1, std::memory_order_release);
+        }
+        else {
+            if (Capacity - (position - producer_head) < wanted)
+                producer_head = head.load(std::memory_order_acquire);
+            count = std::min(wanted, Capacity - (position - producer_head));
+            if (count == 0)
+                return 0;
+            fill(position, count);
+            tail.store(position + count, std::memory_order_release);
+        }
+        return count;
+    }
+
+    // Reads up to 'wanted' published elements with read(position, count) and releases their slots
+    template<typename F>
+    size_t take(size_t wanted, F read)
+    {
+        const size_t position = head.load(std::memory_order_relaxed);
+        const size_t count = readable(position, std::min(wanted, Capacity - (position & mask)));
+        if (count > 0) {
+            read(position, count);
+            release(position, count);
+        }
+        return count;
+    }
+
+    size_t readable(size_t position, size_t wanted) const noexcept
+    {
+        if constexpr (Producers::multiple) {
+            size_t count = 0;
+            while (count < wanted && sequence[(position + count) & mask].load(std::memory_order_acquire) == position + count + 1)
+                ++count;
+            return count;
+        }
+        else {
+            if (consumer_tail - position < wanted)
+                consumer_tail = tail.load(std::memory_order_acquire);
+            return std::min(wanted, consumer_tail - position);
+        }
+    }
+
+    void release(size_t position, size_t count) noexcept
+    {
+        if constexpr (Producers::multiple)
+            for (size_t i = 0; i < count; ++i)
+                sequence[(position + i) & mask].store(position + i + Capacity, std::memory_order_release);
+        head.store(position + count, std::memory_order_release);
+    }
+
+    template<typename It, size_t ... N>
+    void scatter(It first, size_t position, size_t count, std::index_sequence<N...>)
+    {
+        (..., scatter_field<N>(first, position, count));
+    }
+
+    // Writes a single column, which takes at most two contiguous slices
+    template<size_t N, typename It>
+    void scatter_field(It first, size_t position, size_t count)
+    {
+        auto& column = std::get<N>(this->storage);
+        const size_t begin = position & mask;
+        const size_t slice = std::min(count, Capacity - begin);
+        for (size_t i = 0; i < slice; ++i, ++first)
+            column[begin + i] = boost::pfr::get<N>(*first);
+        for (size_t i = 0; i < count - slice; ++i, ++first)
+            column[i] = boost::pfr::get<N>(*first);
+    }
+
+    // Consumer cursor and the cached producer cursor
+    alignas(64) std::atomic<size_t> head = 0;
+    mutable size_t consumer_tail = 0;
+
+    // Producer cursor and the cached consumer cursor
+    alignas(64) std::atomic<size_t> tail = 0;
+    size_t producer_head = 0;
+
+    alignas(64) std::array<std::atomic<size_t>, Producers::multiple ? Capacity : 0> sequence;
+};
+
+// Append-only vector for many producers. Elements are stored in fixed-size segments,
+// which are never moved, so growth does not invalidate anything.
+// Producers reserve slots with a CAS on the reserved count, fill them, and mark them ready without locks.
+// The published prefix is advanced over ready slots by producers and readers,
+// so readers may scan size() elements while the producers keep going.
+template<typename T, typename Segment, size_t SegmentSize, size_t MaxSegments>
+class BaseConcurrentVector
+{
+    struct Chunk
+    {
+        Segment data;
+        std::array<std::atomic<bool>, SegmentSize> ready;
+    };
+
+public:
+    BaseConcurrentVector() : chunks(new std::atomic<Chunk*>[MaxSegments]) {
+        for (size_t i = 0; i < MaxSegments; ++i)
+            chunks[i].store(nullptr, std::memory_order_relaxed);
+    }
+
+    BaseConcurrentVector(const BaseConcurrentVector&) = delete;
+    BaseConcurrentVector& operator=(const BaseConcurrentVector&) = delete;
+
+    ~BaseConcurrentVector()
+    {
+        for (size_t i = 0; i < MaxSegments; ++i)
+            delete chunks[i].load(std::memory_order_relaxed);
+    }
+
+    static constexpr size_t max_size() noexcept { return SegmentSize * MaxSegments; }
+
+    // Number of published elements
+    size_t size() const noexcept { return advance(); }
+    bool empty() const noexcept { return size() == 0; }
+
+    // Elements may be accessed only within the published prefix or by their producers
+    auto operator[](size_t index) noexcept { return get_chunk(index / SegmentSize)->data[index % SegmentSize]; }
+    auto operator[](size_t index) const noexcept { return std::as_const(get_chunk(index / SegmentSize)->data)[index % SegmentSize]; }
+
+    // Returns the index of the element
+    size_t push_back(const T& value) { return append(1, [&](auto e) { e = value; }); }
+    size_t push_back(T&& value) { return append(1, [&](auto e) { e = std::move(value); }); }
+
+    // Reserves a range of slots at once and returns the index of the first one
+    template<typename It>
+    size_t push_back(It first, It last)
+    {
+        return append(std::distance(first, last), [&](auto e) { e = *first++; });
+    }
+
+    // Calls f(facade) for all published elements
+    template<typename F>
+    void for_each(F f) const
+    {
+        const size_t s = size();
+        for (size_t i = 0; i < s; i += SegmentSize) {
+            const auto& segment = std::as_const(get_chunk(i / SegmentSize)->data);
+            for (size_t j = 0; j < std::min(SegmentSize, s - i); ++j)
+                f(segment[j]);
+        }
+    }
+
+private:
+    template<typename F>
+    size_t append(size_t count, F fill)
+    {
+        // The reservation is committed only if it fits, so a failed append leaves no gap
+        size_t first = reserved.load(std::memory_order_relaxed);
+        do {
+            if (count > max_size() - first)
+                throw std::length_error("Concurrent container is full");
+        } while (!reserved.compare_exchange_weak(first, first + count, std::memory_order_relaxed));
+
+        for (size_t i = first; i < first + count; ++i) {
+            Chunk* chunk = allocate_chunk(i / SegmentSize);
+            fill(chunk->data[i % SegmentSize]);
+            chunk->ready[i % SegmentSize].store(true, std::memory_order_release);
+        }
+        advance();
+        return first;
+    }
+
+    // Moves the published prefix over the ready slots
+    size_t advance() const noexcept
+    {
+        size_t current = published.load(std::memory_order_acquire);
+        size_t last = current;
+        while (last < max_size() && is_ready(last))
+            ++last;
+        while (current < last)
+            if (published.compare_exchange_weak(current, last, std::memory_order_acq_rel, std::memory_order_acquire))
+                return last;
+        return current;
+    }
+
+    bool is_ready(size_t index) const noexcept
+    {
+        const Chunk* chunk = get_chunk(index / SegmentSize);
+        return chunk != nullptr && chunk->ready[index % SegmentSize].load(std::memory_order_acquire);
+    }
+
+    Chunk* get_chunk(size_t index) const noexcept { return chunks[index].load(std::memory_order_acquire); }
+
+    Chunk* allocate_chunk(size_t index)
+    {
+        Chunk* chunk = get_chunk(index);
+        if (chunk != nullptr)
+            return chunk;
+
+        auto candidate = std::make_unique<Chunk>();
+        if (chunks[index].compare_exchange_strong(chunk, candidate.get(), std::memory_order_acq_rel, std::memory_order_acquire))
+            return candidate.release();
+        return chunk;
+    }
+
+    std::unique_ptr<std::atomic<Chunk*>[]> chunks;
+    alignas(64) std::atomic<size_t> reserved = 0;
+    alignas(64) mutable std::atomic<size_t> published = 0;
+};
+
+template<typename T, size_t SegmentSize = (1 << 14), size_t MaxSegments = (1 << 14)>
+using ConcurrentAoSVector = BaseConcurrentVector<T, AoSArray<T, SegmentSize>, SegmentSize, MaxSegments>;
+
+template<typename T, size_t SegmentSize = (1 << 14), size_t MaxSegments = (1 << 14)>
+using ConcurrentSoAVector = BaseConcurrentVector<T, SoAArray<T, SegmentSize>, SegmentSize, MaxSegments>;
+
+// Open-addressing hash table with linear probing which maps keys to indices.
+// Control bytes, keys, and indices are stored in separate arrays, so probing touches only
+// control bytes and keys.
+template<typename K>
+class OpenAddressingTable
+{
+public:
+    static const constexpr size_t npos = size_t(-1);
+
+    explicit OpenAddressingTable(size_t expected = 0) { reserve(expected); }
+
+    auto size() const noexcept { return count; }
+    bool empty() const noexcept { return count == 0; }
+
+    void reserve(size_t expected)
+    {
+        size_t capacity = 16;
+        while (capacity < 2 * expected)
+            capacity *= 2;
+        if (capacity > control.size())
+            rehash(capacity);
+    }
+
+    // Inserts the key if it is absent; returns the mapped index and whether insertion took place
+    std::pair<size_t&, bool> emplace(const K& key, size_t index)
+    {
+        if (2 * (count + deleted + 1) > control.size())
+            rehash(2 * (count + 1) > control.size() ? 2 * control.size() : control.size());
+
+        size_t tombstone = npos;
+        size_t slot = home(key);
+        for (; control[slot] != EMPTY; slot = next(slot)) {
+            if (control[slot] == DELETED) {
+                if (tombstone == npos)
+                    tombstone = slot;
+            }
+            else if (keys[slot] == key) {
+                return { indices[slot], false };
+            }
+        }
+        if (tombstone != npos) {
+            slot = tombstone;
+            --deleted;
+        }
+        control[slot] = FULL;
+        keys[slot] = key;
+        indices[slot] = index;
+        ++count;
+        return { indices[slot], true };
+    }
+
+    size_t find(const K& key) const noexcept
+    {
+        const size_t slot = lookup(key);
+        return slot == npos ? npos : indices[slot];
+    }
+
+    bool erase(const K& key) noexcept
+    {
+        const size_t slot = lookup(key);
+        if (slot == npos)
+            return false;
+        control[slot] = DELETED;
+        --count;
+        ++deleted;
+        return true;
+    }
+
+    void clear() noexcept
+    {
+        std::fill(control.begin(), control.end(), EMPTY);
+        count = 0;
+        deleted = 0;
+    }
+
+private:
+    static const constexpr uint8_t EMPTY = 0;
+    static const constexpr uint8_t FULL = 1;
+    static const constexpr uint8_t DELETED = 2;
+
+    // Fibonacci hashing spreads sequential and patterned keys
+    size_t home(const K& key) const noexcept
+    {
+        const uint64_t hash = static_cast<uint64_t>(std::hash<K>{}(key)) * 0x9E3779B97F4A7C15ull;
+        return static_cast<size_t>(hash >> shift);
+    }
+
+    size_t next(size_t slot) const noexcept { return (slot + 1) & (control.size() - 1); }
+
+    size_t lookup(const K& key) const noexcept
+    {
+        if (control.empty())
+            return npos;
+        for (size_t slot = home(key); control[slot] != EMPTY; slot = next(slot))
+            if (control[slot] == FULL && keys[slot] == key)
+                return slot;
+        return npos;
+    }
+
+    void rehash(size_t capacity)
+    {
+        auto old_control = std::move(control);
+        auto old_keys = std::move(keys);
+        auto old_indices = std::move(indices);
+
+        control.assign(capacity, EMPTY);
+        keys.assign(capacity, K{});
+        indices.assign(capacity, npos);
+        shift = 64;
+        for (size_t i = capacity; i > 1; i /= 2)
+            --shift;
+
+        for (size_t i = 0; i < old_control.size(); ++i) {
+            if (old_control[i] != FULL)
+                continue;
+            size_t slot = home(old_keys[i]);
+            while (control[slot] != EMPTY)
+                slot = next(slot);
+            control[slot] = FULL;
+            keys[slot] = std::move(old_keys[i]);
+            indices[slot] = old_indices[i];
+        }
+        deleted = 0;
+    }
+
+    std::vector<uint8_t> control;
+    std::vector<K> keys;
+    std::vector<size_t> indices;
+    size_t count = 0;
+    size_t deleted = 0;
+    unsigned shift = 64;
+};
+
+// Aggregates of GroupBy. Accumulator types are taken from the output row structure.
+struct CountOf
+{
+    template<typename U, typename Column>
+    static U start(const Column&, size_t) { return U{}; }
+    template<typename U>
+    static void merge(U& accumulator, const U& other) { accumulator += other; }
+};
+
+template<auto field>
+struct SumOf
+{
+    static const constexpr auto member = field;
+    template<typename U, typename Column>
+    static U start(const Column&, size_t) { return U{}; }
+    template<typename U, typename V>
+    static void update(U& accumulator, const V& value) { accumulator += value; }
+    template<typename U>
+    static void merge(U& accumulator, const U& other) { accumulator += other; }
+};
+
+template<auto field>
+struct MinOf
+{
+    static const constexpr auto member = field;
+    template<typename U, typename Column>
+    static U start(const Column& column, size_t first) { return column[first]; }
+    template<typename U, typename V>
+    static void update(U& accumulator, const V& value) { if (value < accumulator) accumulator = value; }
+    template<typename U>
+    static void merge(U& accumulator, const U& other) { update(accumulator, other); }
+};
+
+template<auto field>
+struct MaxOf
+{
+    static const constexpr auto member = field;
+    template<typename U, typename Column>
+    static U start(const Column& column, size_t first) { return column[first]; }
+    template<typename U, typename V>
+    static void update(U& accumulator, const V& value) { if (accumulator < value) accumulator = value; }
+    template<typename U>
+    static void merge(U& accumulator, const U& other) { update(accumulator, other); }
+};
+
+// Lazy group-by query: storage.group_by<&T::key>().sum<&T::value>().count().collect<Row>()
+// The first field of Row is the key, the following ones are accumulators in the order of aggregates.
+// Key column is hashed once to group indices, then each aggregated column is streamed separately.
+template<typename Container, auto key, typename ... Aggregates>
+class GroupBy
+{
+    using K = MemberType<key>;
+    template<typename Aggregate> using With = GroupBy<Container, key, Aggregates..., Aggregate>;
+
+public:
+    explicit GroupBy(const Container& c) noexcept : container(c) { }
+
+    auto count() const noexcept { return With<CountOf>(container); }
+
+    template<auto field>
+    auto sum() const noexcept { return With<SumOf<field>>(container); }
+
+    template<auto field>
+    auto min() const noexcept { return With<MinOf<field>>(container); }
+
+    template<auto field>
+    auto max() const noexcept { return With<MaxOf<field>>(container); }
+
+    // Large inputs are partitioned across threads; zero means choose automatically.
+    // Throws std::length_error if a partition has more than 2^32 groups.
+    template<typename Row>
+    SoAVector<Row> collect(size_t threads = 0) const
+    {
+        static_assert(boost::pfr::tuple_size_v<Row> == sizeof...(Aggregates) + 1, "Row must contain a key and all the aggregates");
+        using Indices = std::index_sequence_for<Aggregates...>;
+
+        const size_t size = container.size();
+        if (threads == 0)
+            threads = std::clamp<size_t>(size / ROWS_PER_THREAD, 1, std::max(1u, std::thread::hardware_concurrency()));
+
+        std::vector<Partial<Row>> partials(threads);
+        if (threads == 1) {
+            aggregate_range(partials[0], 0, size, Indices{});
+        }
+        else {
+            std::vector<std::thread> workers;
+            for (size_t t = 0; t < threads; ++t)
+                workers.emplace_back([&, t] { aggregate_range(partials[t], size * t / threads, size * (t + 1) / threads, Indices{}); });
+            for (auto& worker : workers)
+                worker.join();
+        }
+
+        // Merging in order of partitions keeps groups in order of the first appearance
+        Partial<Row> result = std::move(partials[0]);
+        OpenAddressingTable<K> table(result.keys.size());
+        for (size_t g = 0; g < result.keys.size(); ++g)
+            table.emplace(result.keys[g], g);
+        for (size_t t = 1; t < threads; ++t)
+            merge(result, table, partials[t], Indices{});
+
+        SoAVector<Row> output;
+        output.reserve(result.keys.size());
+        for (size_t g = 0; g < result.keys.size(); ++g)
+            output.push_back(make_row<Row>(result, g, Indices{}));
+        return output;
+    }
+
+private:
+    static const constexpr size_t ROWS_PER_THREAD = 1 << 16;
+
+    // Group indices of rows are 32-bit to halve the traffic of aggregation passes,
+    // so each partition may have at most 2^32 groups
+    static const constexpr size_t MAX_GROUP = std::numeric_limits<uint32_t>::max();
+
+    template<typename Row, size_t I>
+    using Accumulator = std::remove_cv_t<boost::pfr::tuple_element_t<I + 1, Row>>;
+
+    template<typename Row, typename Indices = std::index_sequence_for<Aggregates...>> struct PartialImpl;
+    template<typename Row, size_t ... I>
+    struct PartialImpl<Row, std::index_sequence<I...>>
+    {
+        std::vector<K> keys;
+        std::tuple<std::vector<Accumulator<Row, I>>...> accumulators;
+    };
+
+    template<typename Row>
+    using Partial = PartialImpl<Row>;
+
+    template<typename Row, size_t ... I>
+    void aggregate_range(Partial<Row>& partial, size_t begin, size_t end, std::index_sequence<I...>) const
+    {
+        const auto& keys = container.template column<key>();
+        OpenAddressingTable<K> table;
+        std::vector<size_t> first;
+        std::vector<uint32_t> groups(end - begin);
+        for (size_t i = begin; i < end; ++i) {
+            const auto result = table.emplace(keys[i], partial.keys.size());
+            if (result.second) {
+                if (partial.keys.size() > MAX_GROUP)
+                    throw std::length_error("Too many groups");
+                partial.keys.push_back(keys[i]);
+                first.push_back(i);
+            }
+            groups[i - begin] = static_cast<uint32_t>(result.first);
+        }
+        (aggregate_column<Aggregates>(std::get<I>(partial.accumulators), first, groups, begin), ...);
+    }
+
+    template<typename Aggregate, typename U>
+    void aggregate_column(std::vector<U>& accumulators, const std::vector<size_t>& first, const std::vector<uint32_t>& groups, size_t begin) const
+    {
+        if constexpr (std::is_same_v<Aggregate, CountOf>) {
+            accumulators.assign(first.size(), U{});
+            for (auto group : groups)
+                accumulators[group] += 1;
+        }
+        else {
+            const auto& column = container.template column<Aggregate::member>();
+            accumulators.reserve(first.size());
+            for (auto row : first)
+                accumulators.push_back(Aggregate::template start<U>(column, row));
+            for (size_t i = 0; i < groups.size(); ++i)
+                Aggregate::update(accumulators[groups[i]], column[begin + i]);
+        }
+    }
+
+    template<typename Row, size_t ... I>
+    static void merge(Partial<Row>& result, OpenAddressingTable<K>& table, const Partial<Row>& partial, std::index_sequence<I...>)
+    {
+        for (size_t g = 0; g < partial.keys.size(); ++g) {
+            const auto found = table.emplace(partial.keys[g], result.keys.size());
+            if (found.second) {
+                result.keys.push_back(partial.keys[g]);
+                (std::get<I>(result.accumulators).push_back(std::get<I>(partial.accumulators)[g]), ...);
+            }
+            else {
+                (Aggregates::merge(std::get<I>(result.accumulators)[found.first], std::get<I>(partial.accumulators)[g]), ...);
+            }
+        }
+    }
+
+    template<typename Row, size_t ... I>
+    static Row make_row(const Partial<Row>& partial, size_t g, std::index_sequence<I...>)
+    {
+        Row row{};
+        boost::pfr::get<0>(row) = partial.keys[g];
+        ((void)(boost::pfr::get<I + 1>(row) = std::get<I>(partial.accumulators)[g]), ...);
+        return row;
+    }
+
+    const Container& container;
+};
+
+// Equi-join of two containers on key fields. The build side is an open-addressing table
+// over the left key column only, the probe side streams the right key column.
+// out(left[i], right[j]) is called for every matching pair of rows, so only the fields
+// read by the callback are gathered. Matches are reported in order of right rows,
+// and then in order of left rows. Returns the number of matches.
+template<auto left_key, auto right_key, typename Left, typename Right, typename Out>
+size_t hash_join(Left& left, Right& right, Out out)
+{
+    using K = MemberType<left_key>;
+    static_assert(std::is_same_v<K, MemberType<right_key>>, "Key fields must have the same type");
+    static const constexpr size_t npos = OpenAddressingTable<K>::npos;
+
+    // Build backwards, so each chain lists rows in ascending order
+    const auto& build_keys = left.template column<left_key>();
+    OpenAddressingTable<K> table(left.size());
+    std::vector<size_t> next(left.size(), npos);
+    for (size_t i = left.size(); i-- > 0; ) {
+        auto head = table.emplace(build_keys[i], i);
+        if (!head.second) {
+            next[i] = head.first;
+            head.first = i;
+        }
+    }
+
+    size_t matches = 0;
+    const auto& probe_keys = right.template column<right_key>();
+    for (size_t j = 0; j < right.size(); ++j) {
+        for (size_t i = table.find(probe_keys[j]); i != npos; i = next[i]) {
+            out(left[i], right[j]);
+            ++matches;
+        }
+    }
+    return matches;
+}
+
+// Secondary index over a field of any container, which maps unique keys to element indices.
+// The index is built with a single pass over the key column, and must be updated explicitly
+// by insert and erase when the container changes.
+template<auto key>
+class HashIndex
+{
+    using K = MemberType<key>;
+public:
+    static const constexpr size_t npos = OpenAddressingTable<K>::npos;
+
+    HashIndex() = default;
+
+    template<typename Container>
+    explicit HashIndex(const Container& container) { build(container); }
+
+    // If keys are duplicated, the first element is indexed
+    template<typename Container>
+    void build(const Container& container)
+    {
+        const auto& keys = container.template column<key>();
+        table.clear();
+        table.reserve(container.size());
+        for (size_t i = 0; i < container.size(); ++i)
+            table.emplace(keys[i], i);
+    }
+
+    // Returns an index of the element, or npos if the key is not found
+    size_t find(const K& k) const noexcept { return table.find(k); }
+    bool contains(const K& k) const noexcept { return find(k) != npos; }
+
+    // Maps the key to the index; returns false if the key was already mapped and just updated
+    bool insert(const K& k, size_t index)
+    {
+        auto result = table.emplace(k, index);
+        result.first = index;
+        return result.second;
+    }
+
+    bool erase(const K& k) noexcept { return table.erase(k); }
+    void clear() noexcept { table.clear(); }
+
+    auto size() const noexcept { return table.size(); }
+    bool empty() const noexcept { return table.empty(); }
+
+private:
+    OpenAddressingTable<K> table;
+};
+
+inline unsigned count_trailing_ones(uint64_t value) noexcept
+{
+#if defined(__GNUC__)
+    return value == ~uint64_t{} ? 64 : __builtin_ctzll(~value);
+#else
+    unsigned result = 0;
+    for (; (value & 1) != 0; value >>= 1)
+        ++result;
+    return result;
+#endif
+}
+
+inline unsigned count_trailing_zeros(uint64_t value) noexcept { return count_trailing_ones(~value); }
+
+// Read-only table kept sorted by the key field. Rows are stored in SoAVector, and a copy of
+// the key column is stored in Eytzinger (BFS) order, so the search is branchless and
+// prefetches the descendants log2(64 / sizeof(key)) levels ahead: four levels for 4-byte keys,
+// three for 8-byte keys, and fewer for wider keys.
+template<typename T, auto key>
+class SortedSoATable
+{
+    using K = MemberType<key>;
+public:
+    using value_type = T;
+    using const_iterator = typename SoAVector<T>::const_iterator;
+
+    SortedSoATable() = default;
+
+    template<typename Container>
+    explicit SortedSoATable(const Container& container) { assign(container); }
+
+    template<typename Container>
+    void assign(const Container& container)
+    {
+        const auto& keys = container.template column<key>();
+        std::vector<size_t> order(container.size());
+        for (size_t i = 0; i < order.size(); ++i)
+            order[i] = i;
+        std::stable_sort(order.begin(), order.end(), [&](size_t a, size_t b) { return keys[a] < keys[b]; });
+
+        data = SoAVector<T>();
+        data.reserve(order.size());
+        for (auto i : order)
+            data.push_back(container[i].aggregate());
+
+        tree.assign(data.size() + 1, K{});
+        ranks.assign(data.size() + 1, data.size());
+        build(data.template column<key>(), 0, 1);
+    }
+
+    auto size() const noexcept { return data.size(); }
+    bool empty() const noexcept { return data.empty(); }
+
+    auto operator[](size_t index) const noexcept { return data[index]; }
+    auto begin() const noexcept { return data.begin(); }
+    auto end() const noexcept { return data.end(); }
+    const SoAVector<T>& rows() const noexcept { return data; }
+
+    // Positions of the first row with key not less than (lower) or greater than (upper) the value
+    size_t lower_bound(const K& value) const noexcept { return search(value, std::less<K>{}); }
+    size_t upper_bound(const K& value) const noexcept { return search(value, std::less_equal<K>{}); }
+
+    auto equal_range(const K& value) const noexcept { return make_range(lower_bound(value), upper_bound(value)); }
+
+    // Rows with keys in [low, high)
+    auto range(const K& low, const K& high) const noexcept { return make_range(lower_bound(low), lower_bound(high)); }
+
+private:
+    // Descendants of node k at the depth log2(KEYS_PER_LINE) occupy a single line worth of keys
+    // starting at k * KEYS_PER_LINE, which spans at most two cache lines of the unaligned tree
+    static const constexpr size_t KEYS_PER_LINE = std::max<size_t>(64 / sizeof(K), 1);
+
+    template<typename Keys>
+    size_t build(const Keys& keys, size_t i, size_t k)
+    {
+        if (k < tree.size()) {
+            i = build(keys, i, 2 * k);
+            tree[k] = keys[i];
+            ranks[k] = i++;
+            i = build(keys, i, 2 * k + 1);
+        }
+        return i;
+    }
+
+    template<typename Less>
+    size_t search(const K& value, Less less) const noexcept
+    {
+        const size_t n = data.size();
+        uint64_t k = 1;
+        while (k <= n) {
+            prefetch_read(tree.data() + std::min<size_t>(k * KEYS_PER_LINE, n));
+            k = 2 * k + (less(tree[k], value) ? 1 : 0);
+        }
+        // Drop the trailing right turns and the last left turn
+        k >>= count_trailing_ones(k) + 1;
+        return ranks[k];
+    }
+
+    std::pair<const_iterator, const_iterator> make_range(size_t first, size_t last) const noexcept
+    {
+        return { std::next(begin(), first), std::next(begin(), std::max(first, last)) };
+    }
+
+    SoAVector<T> data;
+    std::vector<K> tree = std::vector<K>(1);
+    std::vector<size_t> ranks = std::vector<size_t>(1, 0);
+};
+
+// Containers which log ranges written by their bulk operations
+template<typename Container, typename = void>
+struct HasWriteLog : std::false_type { };
+
+template<typename Container>
+struct HasWriteLog<Container, std::enable_if_t<Container::logs_writes>> : std::true_type { };
+
+// Minimum and maximum values of the fields per block of elements, which allow scans to skip blocks.
+// A zone map follows a single container. If the container has WriteLog policy, ranges written by
+// its bulk operations are never skipped, and refresh() recomputes their blocks. Other writes,
+// including all writes through facades and batch facades, must be invalidated explicitly.
+// refresh() recomputes only invalidated and written blocks, and blocks affected by resizing.
+template<auto ... fields>
+class ZoneMap
+{
+    template<auto field>
+    using Zones = std::vector<std::pair<MemberType<field>, MemberType<field>>>;
+
+public:
+    explicit ZoneMap(size_t block_size = 4096) noexcept : block(block_size) { }
+
+    template<typename Container>
+    explicit ZoneMap(const Container& container, size_t block_size = 4096) : block(block_size) { refresh(container); }
+
+    auto block_size() const noexcept { return block; }
+
+    void invalidate(size_t index) noexcept { invalidate(index, index + 1); }
+
+    void invalidate(size_t first, size_t last) noexcept
+    {
+        for (size_t b = first / block; b < valid.size() && b * block < last; ++b)
+            valid[b] = 0;
+    }
+
+    void invalidate() noexcept { std::fill(valid.begin(), valid.end(), 0); }
+
+    template<typename Container>
+    void refresh(const Container& container)
+    {
+        if constexpr (HasWriteLog<Container>::value) {
+            container.visit_writes(generation, [&](size_t first, size_t last) { invalidate(first, last); });
+            generation = container.write_generation();
+        }
+
+        // The last block of the old size may be partial, so it is recomputed too
+        if (container.size() != rows)
+            invalidate(std::min(container.size(), rows) / block * block, rows);
+
+        rows = container.size();
+        const size_t blocks = (rows + block - 1) / block;
+        valid.resize(blocks, 0);
+        (std::get<index_of<fields>()>(zones).resize(blocks), ...);
+
+        for (size_t b = 0; b < blocks; ++b) {
+            if (valid[b] != 0)
+                continue;
+            const size_t first = b * block;
+            const size_t length = std::min(block, rows - first);
+            ((std::get<index_of<fields>()>(zones)[b] = kernels::minmax(column_begin(container.template column<fields>(), first), length)), ...);
+            valid[b] = 1;
+        }
+    }
+
+    // Same as storage.find<field>(value), but skips blocks which cannot contain the value
+    template<auto field, typename Container>
+    auto find(Container& container, const MemberType<field>& value) const
+    {
+        const auto& column = container.template column<field>();
+        size_t result = container.size();
+        for_each_block<field>(container, value, value, [&](size_t first, size_t length) {
+            const size_t index = kernels::find(column_begin(column, first), length, value);
+            if (index == length)
+                return true;
+            result = first + index;
+            return false;
+        });
+        return std::next(container.begin(), result);
+    }
+
+    // Calls f(container[i]) for each element with low <= value <= high, skipping blocks out of the range
+    template<auto field, typename Container, typename F>
+    void scan(Container& container, const MemberType<field>& low, const MemberType<field>& high, F f) const
+    {
+        const auto& column = container.template column<field>();
+        for_each_block<field>(container, low, high, [&](size_t first, size_t length) {
+            for (size_t i = first; i < first + length; ++i)
+                if (!(column[i] < low) && !(high < column[i]))
+                    f(container[i]);
+            return true;
+        });
+    }
+
+private:
+    template<auto a, auto b>
+    static constexpr bool same_member() noexcept
+    {
+        if constexpr (std::is_same_v<decltype(a), decltype(b)>)
+            return a == b;
+        else
+            return false;
+    }
+
+    template<auto field>
+    static constexpr size_t index_of() noexcept
+    {
+        size_t result = sizeof...(fields);
+        size_t i = 0;
+        ((result = same_member<field, fields>() && result == sizeof...(fields) ? i : result, ++i), ...);
+        return result;
+    }
+
+    // Blocks which are invalid, were not refreshed yet, or were written since the refresh are never skipped
+    template<auto field, typename Container, typename F>
+    void for_each_block(const Container& container, const MemberType<field>& low, const MemberType<field>& high, F f) const
+    {
+        static_assert(index_of<field>() < sizeof...(fields), "Field is not covered by the zone map");
+        std::array<std::pair<size_t, size_t>, WriteLog::capacity> written;
+        size_t writes = 0;
+        if constexpr (HasWriteLog<Container>::value)
+            container.visit_writes(generation, [&](size_t first, size_t last) { written[writes++] = { first, last}; });
+        auto is_written = [&](size_t first, size_t last) {
+            for (size_t i = 0; i < writes; ++i)
+                if (written[i].first < last && first < written[i].second)
+                    return true;
+            return false;
+        };
+
+        const auto& zones_of_field = std::get<index_of<field>()>(zones);
+        for (size_t first = 0, b = 0; first < container.size(); first += block, ++b) {
+            const size_t length = std::min(block, container.size() - first);
+            const bool stale = b >= valid.size() || valid[b] == 0 || first + length > rows || is_written(first, first + length);
+            if (!stale && (high < zones_of_field[b].first || zones_of_field[b].second < low))
+                continue;
+            if (!f(first, length))
+                return;
+        }
+    }
+
+    size_t block;
+    size_t rows = 0;
+    uint64_t generation = 0;
+    std::vector<char> valid;
+    std::tuple<Zones<fields>...> zones;
+};
+
+// Group of control bytes of a hash map, which are matched at once with SSE2 where possible.
+// Full slots keep 7 bits of the hash, free slots have negative control bytes.
+class ControlGroup
+{
+public:
+    static const constexpr size_t width = 16;
+    static const constexpr int8_t EMPTY = -128;
+    static const constexpr int8_t DELETED = -2;
+
+#if defined(__SSE2__)
+    explicit ControlGroup(const int8_t* control) noexcept : bytes(_mm_loadu_si128(reinterpret_cast<const __m128i*>(control))) { }
+
+    uint32_t match(int8_t tag) const noexcept { return uint32_t(_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_set1_epi8(tag), bytes))); }
+    uint32_t match_free() const noexcept { return uint32_t(_mm_movemask_epi8(bytes)); }
+#else
+    explicit ControlGroup(const int8_t* control) noexcept : bytes(control) { }
+
+    uint32_t match(int8_t tag) const noexcept
+    {
+        uint32_t result = 0;
+        for (size_t i = 0; i < width; ++i)
+            result |= uint32_t(bytes[i] == tag) << i;
+        return result;
+    }
+
+    uint32_t match_free() const noexcept
+    {
+        uint32_t result = 0;
+        for (size_t i = 0; i < width; ++i)
+            result |= uint32_t(bytes[i] < 0) << i;
+        return result;
+    }
+#endif
+
+    uint32_t match_empty() const noexcept { return match(EMPTY); }
+
+private:
+#if defined(__SSE2__)
+    __m128i bytes;
+#else
+    const int8_t* bytes;
+#endif
+};
+
+// Open-addressing hash map, which stores control bytes, keys, and values in separate columns.
+// Probing matches a group of control bytes at once and touches only keys with the same hash tag;
+// values are stored in a vector aligned to the slots and accessed through facades.
+template<typename K, typename V, typename Values>
+class BaseHashMap
+{
+public:
+    using reference = typename Values::reference;
+    using const_reference = typename Values::const_reference;
+
+    explicit BaseHashMap(size_t expected = 0) { reserve(expected); }
+
+    auto size() const noexcept { return count; }
+    bool empty() const noexcept { return count == 0; }
+
+    void reserve(size_t expected)
+    {
+        size_t capacity = ControlGroup::width;
+        while (capacity * 7 / 8 < expected)
+            capacity *= 2;
+        if (capacity > control.size())
+            rehash(capacity);
+    }
+
+    // Inserts the value if the key is absent; returns the facade of the mapped value and whether insertion took place
+    std::pair<reference, bool> insert(const K& key, const V& value)
+    {
+        const auto result = emplace(key);
+        if (result.second)
+            values[result.first] = value;
+        return { values[result.first], result.second };
+    }
+
+    // Inserts a value-initialized element if the key is absent
+    reference operator[](const K& key) { return values[emplace(key).first]; }
+
+    reference at(const K& key) { return values[checked_lookup(key)]; }
+    const_reference at(const K& key) const { return values[checked_lookup(key)]; }
+
+    bool contains(const K& key) const noexcept { return lookup(key) != npos; }
+
+    // Facade of the mapped value, if the key is present
+    std::optional<reference> find(const K& key) noexcept
+    {
+        const size_t slot = lookup(key);
+        return slot == npos ? std::nullopt : std::optional<reference>(values[slot]);
+    }
+
+    std::optional<const_reference> find(const K& key) const noexcept
+    {
+        const size_t slot = lookup(key);
+        return slot == npos ? std::nullopt : std::optional<const_reference>(values[slot]);
+    }
+
+    bool erase(const K& key)
+    {
+        const size_t slot = lookup(key);
+        if (slot == npos)
+            return false;
+
+        // If the group has an empty slot, no probe has ever passed it, so the slot may become empty
+        const size_t group = slot / ControlGroup::width * ControlGroup::width;
+        if (ControlGroup(&control[group]).match_empty() != 0) {
+            control[slot] = ControlGroup::EMPTY;
+        }
+        else {
+            control[slot] = ControlGroup::DELETED;
+            ++deleted;
+        }
+        keys[slot] = K{};
+        values[slot] = V{};
+        --count;
+        return true;
+    }
+
+    void clear()
+    {
+        const size_t capacity = control.size();
+        control.clear();
+        rehash(capacity);
+    }
+
+    // Calls f(key, facade) for all elements in unspecified order
+    template<typename F>
+    void for_each(F f)
+    {
+        for (size_t slot = 0; slot < control.size(); ++slot)
+            if (control[slot] >= 0)
+                f(std::as_const(keys[slot]), values[slot]);
+    }
+
+    template<typename F>
+    void for_each(F f) const
+    {
+        for (size_t slot = 0; slot < control.size(); ++slot)
+            if (control[slot] >= 0)
+                f(keys[slot], values[slot]);
+    }
+
+private:
+    static const constexpr size_t npos = size_t(-1);
+
+    uint64_t hash_of(const K& key) const noexcept { return static_cast<uint64_t>(std::hash<K>{}(key)) * 0x9E3779B97F4A7C15ull; }
+
+    // High bits of the hash select the group, low bits are stored in the control byte
+    size_t home(uint64_t hash) const noexcept { return shift == 64 ? 0 : static_cast<size_t>(hash >> shift); }
+    static int8_t tag(uint64_t hash) noexcept { return static_cast<int8_t>(hash & 0x7F); }
+
+    size_t groups() const noexcept { return control.size() / ControlGroup::width; }
+
+    size_t lookup(const K& key) const noexcept
+    {
+        const uint64_t hash = hash_of(key);
+        for (size_t g = home(hash), probes = 0; probes < groups(); g = (g + 1) & (groups() - 1), ++probes) {
+            const size_t first = g * ControlGroup::width;
+            const ControlGroup group(&control[first]);
+            for (uint32_t match = group.match(tag(hash)); match != 0; match &= match - 1) {
+                const size_t slot = first + count_trailing_zeros(match);
+                if (keys[slot] == key)
+                    return slot;
+            }
+            if (group.match_empty() != 0)
+                return npos;
+        }
+        return npos;
+    }
+
+    size_t checked_lookup(const K& key) const
+    {
+        const size_t slot = lookup(key);
+        if (slot == npos)
+            throw std::out_of_range("Key is not found in hash map");
+        return slot;
+    }
+
+    size_t find_free(uint64_t hash) const noexcept
+    {
+        for (size_t g = home(hash);; g = (g + 1) & (groups() - 1)) {
+            const uint32_t match = ControlGroup(&control[g * ControlGroup::width]).match_free();
+            if (match != 0)
+                return g * ControlGroup::width + count_trailing_zeros(match);
+        }
+    }
+
+    std::pair<size_t, bool> emplace(const K& key)
+    {
+        const size_t found = lookup(key);
+        if (found != npos)
+            return { found, false };
+
+        if (8 * (count + deleted + 1) > 7 * control.size())
+            rehash(16 * (count + 1) > 7 * control.size() ? 2 * control.size() : control.size());
+
+        const uint64_t hash = hash_of(key);
+        const size_t slot = find_free(hash);
+        if (control[slot] == ControlGroup::DELETED)
+            --deleted;
+        control[slot] = tag(hash);
+        keys[slot] = key;
+        ++count;
+        return { slot, true };
+    }
+
+    void rehash(size_t capacity)
+    {
+        auto old_control = std::move(control);
+        auto old_keys = std::move(keys);
+        Values old_values = std::move(values);
+
+        control.assign(capacity, ControlGroup::EMPTY);
+        keys.assign(capacity, K{});
+        values = Values(capacity);
+        shift = 64;
+        for (size_t i = groups(); i > 1; i /= 2)
+            --shift;
+
+        count = 0;
+        deleted = 0;
+        for (size_t i = 0; i < old_control.size(); ++i) {
+            if (old_control[i] < 0)
+                continue;
+            const uint64_t hash = hash_of(old_keys[i]);
+            const size_t slot = find_free(hash);
+            control[slot] = tag(hash);
+            keys[slot] = std::move(old_keys[i]);
+            values[slot] = old_values[i].aggregate_move();
+            ++count;
+        }
+    }
+
+    std::vector<int8_t> control;
+    std::vector<K> keys;
+    Values values;
+    size_t count = 0;
+    size_t deleted = 0;
+    unsigned shift = 64;
+};
+
+template<typename K, typename V>
+using AoSHashMap = BaseHashMap<K, V, AoSVector<V>>;
+
+template<typename K, typename V>
+using SoAHashMap = BaseHashMap<K, V, SoAVector<V>>;
+
+// Interleaves bits of coordinates to the Z-order (Morton) code: ...y1x1y0x0
+inline uint64_t morton_code(uint32_t x, uint32_t y) noexcept
+{
+    auto spread = [](uint64_t v) {
+        v = (v | (v << 16)) & 0x0000FFFF0000FFFFull;
+        v = (v | (v << 8))  & 0x00FF00FF00FF00FFull;
+        v = (v | (v << 4))  & 0x0F0F0F0F0F0F0F0Full;
+        v = (v | (v << 2))  & 0x3333333333333333ull;
+        v = (v | (v << 1))  & 0x5555555555555555ull;
+        return v;
+    };
+    return spread(x) | (spread(y) << 1);
+}
+
+// Cell orders of grids. RowMajor stores rows one after another, and the whole grid is a single tile.
+class RowMajor
+{
+public:
+    RowMajor(size_t width, size_t height) noexcept : w(width), h(height) { }
+
+    size_t cells() const noexcept { return w * h; }
+    size_t operator()(size_t x, size_t y) const noexcept { return y * w + x; }
+
+    template<typename F>
+    void for_each_tile(F f) const { f(size_t{0}, size_t{0}, w, h); }
+
+private:
+    size_t w, h;
+};
+
+// Square tiles of TileSize x TileSize cells, which are stored along the Z-order curve.
+// The default tile of 32 x 32 cells is 4 KB for 4-byte fields.
+// Cells of a tile are stored row by row. Grids are padded to whole tiles, and the ranks
+// of tiles on the curve are tabulated, so the curve is not padded to a power of two.
+template<size_t TileSize = 32>
+class MortonTiles
+{
+    static_assert(TileSize > 0 && (TileSize & (TileSize - 1)) == 0, "Tile size must be a power of two");
+    static constexpr size_t shift = [] { size_t s = 0; while ((size_t{1} << s) < TileSize) ++s; return s; }();
+    static constexpr size_t mask = TileSize - 1;
+
+public:
+    static constexpr size_t tile_size = TileSize;
+
+    MortonTiles(size_t width, size_t height)
+        : w(width), h(height), tiles_x((w + mask) >> shift), tiles_y((h + mask) >> shift), rank(tiles_x * tiles_y), order(tiles_x * tiles_y)
+    {
+        std::iota(order.begin(), order.end(), 0);
+        std::sort(order.begin(), order.end(), [this](size_t a, size_t b) {
+            return morton_code(uint32_t(a % tiles_x), uint32_t(a / tiles_x)) < morton_code(uint32_t(b % tiles_x), uint32_t(b / tiles_x));
+        });
+        for (size_t r = 0; r < order.size(); ++r)
+            rank[order[r]] = r;
+    }
+
+    size_t cells() const noexcept { return rank.size() << (2 * shift); }
+
+    size_t operator()(size_t x, size_t y) const noexcept
+    {
+        const size_t tile = rank[(y >> shift) * tiles_x + (x >> shift)];
+        return (tile << (2 * shift)) | ((y & mask) << shift) | (x & mask);
+    }
+
+    // Calls f(x0, y0, x1, y1) for tiles in the storage order; tiles at the borders are clipped
+    template<typename F>
+    void for_each_tile(F f) const
+    {
+        for (size_t tile : order) {
+            const size_t x0 = (tile % tiles_x) << shift;
+            const size_t y0 = (tile / tiles_x) << shift;
+            f(x0, y0, std::min(x0 + TileSize, w), std::min(y0 + TileSize, h));
+        }
+    }
+
+private:
+    size_t w, h;
+    size_t tiles_x, tiles_y;
+    std::vector<uint32_t> rank;  // tile in the row-major order -> tile on the curve
+    std::vector<uint32_t> order; // tile on the curve -> tile in the row-major order
+};
+
+// Two-dimensional grid of cells in AoS or SoA vector. Each SoA column is ordered by the same policy,
+// so the fields are tiled independently. Cells are accessed as grid(x, y)->*(&Cell::field).
+template<typename T, typename Vector, typename Order>
+class BaseGrid2D
+{
+public:
+    using value_type = T;
+
+    BaseGrid2D() : BaseGrid2D(0, 0) { }
+    BaseGrid2D(size_t width, size_t height) : w(width), h(height), order(width, height), storage(order.cells()) { }
+    BaseGrid2D(size_t width, size_t height, const T& value) : BaseGrid2D(width, height) { fill(value); }
+
+    size_t width() const noexcept { return w; }
+    size_t height() const noexcept { return h; }
+
+    auto operator()(size_t x, size_t y) noexcept { return storage[order(x, y)]; }
+    auto operator()(size_t x, size_t y) const noexcept { return storage[order(x, y)]; }
+
+    auto at(size_t x, size_t y) { check_index(x, y); return operator()(x, y); }
+    auto at(size_t x, size_t y) const { check_index(x, y); return operator()(x, y); }
+
+    // Index of the cell in the underlying vector
+    size_t index_of(size_t x, size_t y) const noexcept { return order(x, y); }
+
+    void fill(const T& value) { storage.assign(storage.size(), value); }
+
+    // Calls f(x0, y0, x1, y1) for rectangles [x0, x1) x [y0, y1) of cells in the storage order.
+    // Stencils which iterate by tiles keep the neighbours of the tile in caches.
+    template<typename F>
+    void for_each_tile(F f) const { order.for_each_tile(f); }
+
+    // Cells in the storage order, including padding of tiled grids. Cells of a row of a tile
+    // are consecutive, so kernels may address them by offsets from index_of(x0, y).
+    // The vector must not be resized.
+    const Vector& cells() const noexcept { return storage; }
+    Vector& cells() noexcept { return storage; }
+
+private:
+    void check_index(size_t x, size_t y) const
+    {
+        if (x >= w || y >= h)
+            throw std::out_of_range("Grid is out of range");
+    }
+
+    size_t w, h;
+    Order order;
+    Vector storage;
+};
+
+template<typename T>
+using AoSGrid2D = BaseGrid2D<T, AoSVector<T>, RowMajor>;
+
+template<typename T>
+using SoAGrid2D = BaseGrid2D<T, SoAVector<T>, RowMajor>;
+
+template<typename T, size_t TileSize = 32>
+using TiledAoSGrid2D = BaseGrid2D<T, AoSVector<T>, MortonTiles<TileSize>>;
+
+template<typename T, size_t TileSize = 32>
+using TiledSoAGrid2D = BaseGrid2D<T, SoAVector<T>, MortonTiles<TileSize>>;
+
+// Zero-copy exchange of SoA containers with Arrow consumers by the C Data Interface.
+// Containers are exported as struct arrays with a child array per field, which points
+// to the column in place; nested aggregates of deep layouts are exported as nested structs.
+namespace arrow {
+
+// Number of leaf fields of U before its I-th field
+template<typename U, typename Layout, size_t I>
+constexpr size_t leaf_offset() noexcept
+{
+    if constexpr (I == 0)
+        return 0;
+    else
+        return leaf_offset<U, Layout, I - 1>() + LeafFields<std::remove_cv_t<boost::pfr::tuple_element_t<I - 1, U>>, Layout>::type::size;
+}
+
+template<typename U>
+const char* primitive_format() noexcept
+{
+    if constexpr (std::is_enum_v<U>) {
+        return primitive_format<std::underlying_type_t<U>>();
+    } else {
+        static_assert(std::is_arithmetic_v<U> && !std::is_same_v<U, bool>, "Only numbers, enumerations and arrays of them are exported, Arrow Booleans are bit-packed");
+        static_assert(!std::is_floating_point_v<U> || sizeof(U) == 4 || sizeof(U) == 8, "Arrow has no extended precision numbers");
+        if constexpr (std::is_floating_point_v<U>)
+            return sizeof(U) == 4 ? "f" : "g";
+        else if constexpr (std::is_signed_v<U>)
+            return sizeof(U) == 1 ? "c" : sizeof(U) == 2 ? "s" : sizeof(U) == 4 ? "i" : "l";
+        else
+            return sizeof(U) == 1 ? "C" : sizeof(U) == 2 ? "S" : sizeof(U) == 4 ? "I" : "L";
+    }
+}
+
+struct SchemaData
+{
+    std::string format;
+    std::string name;
+    std::vector<ArrowSchema*> children;
+};
+
+inline void release_schema(ArrowSchema* schema)
+{
+    auto* data = static_cast<SchemaData*>(schema->private_data);
+    for (auto* child : data->children) {
+        if (child->release != nullptr)
+            child->release(child);
+        delete child;
+    }
+    delete data;
+    schema->release = nullptr;
+}
+
+inline void make_schema(ArrowSchema* out, std::string format, std::string name, std::vector<ArrowSchema*> children)
+{
+    auto* data = new SchemaData{ std::move(format), std::move(name), std::move(children) };
+    *out = ArrowSchema{ data->format.c_str(), data->name.c_str(), nullptr, 0,
+                        int64_t(data->children.size()), data->children.empty() ? nullptr : data->children.data(),
+                        nullptr, release_schema, data };
+}
+
+template<typename F, typename Layout>
+ArrowSchema* new_schema(std::string name);
+
+template<typename U, typename Layout, size_t ... I>
+std::vector<ArrowSchema*> field_schemas(const std::vector<std::string>& names, std::index_sequence<I...>)
+{
+    return { new_schema<std::remove_cv_t<boost::pfr::tuple_element_t<I, U>>, Layout>(I < names.size() ? names[I] : "f" + std::to_string(I))... };
+}
+
+template<typename F, typename Layout>
+ArrowSchema* new_schema(std::string name)
+{
+    static_assert(!Layout::template transpose<F>, "Transposed arrays are not contiguous, they cannot be exported");
+    auto* schema = new ArrowSchema;
+    if constexpr (Layout::template flatten<F>) {
+        make_schema(schema, "+s", std::move(name), field_schemas<F, Layout>({}, std::make_index_sequence<boost::pfr::tuple_size_v<F>>{}));
+    } else if constexpr (IsStdArray<F>::value) {
+        static_assert(sizeof(F) == sizeof(typename F::value_type) * std::tuple_size_v<F>, "Arrays must not have padding");
+        make_schema(schema, "+w:" + std::to_string(std::tuple_size_v<F>), std::move(name), { new_schema<typename F::value_type, Layout>("item") });
+    } else {
+        static_assert(!IsNestedAggregate<F>::value, "Nested aggregates are exported by SoA containers with deep layouts only");
+        make_schema(schema, primitive_format<F>(), std::move(name), {});
+    }
+    return schema;
+}
+
+// Owns the pin of the exported container, so each child may be released independently
+struct ArrayData
+{
+    std::shared_ptr<const void> pin;
+    std::vector<const void*> buffers;
+    std::vector<ArrowArray*> children;
+};
+
+inline void release_array(ArrowArray* array)
+{
+    auto* data = static_cast<ArrayData*>(array->private_data);
+    for (auto* child : data->children) {
+        if (child->release != nullptr)
+            child->release(child);
+        delete child;
+    }
+    delete data;
+    array->release = nullptr;
+}
+
+inline ArrowArray* make_array(size_t length, const std::shared_ptr<const void>& pin, std::vector<const void*> buffers, std::vector<ArrowArray*> children)
+{
+    auto* data = new ArrayData{ pin, std::move(buffers), std::move(children) };
+    return new ArrowArray{ int64_t(length), 0, 0, int64_t(data->buffers.size()), int64_t(data->children.size()),
+                           data->buffers.data(), data->children.empty() ? nullptr : data->children.data(),
+                           nullptr, release_array, data };
+}
+
+// Arrow consumers may require data buffers of empty arrays to be non-null
+inline const void* data_buffer(const void* data) noexcept
+{
+    static const int64_t empty = 0;
+    return data != nullptr ? data : &empty;
+}
+
+template<typename Container, typename F, size_t L>
+ArrowArray* field_array(const Container& container, const std::shared_ptr<const void>& pin);
+
+template<typename Container, typename U, size_t L0, size_t ... I>
+std::vector<ArrowArray*> field_arrays(const Container& container, const std::shared_ptr<const void>& pin, std::index_sequence<I...>)
+{
+    using Layout = typename Container::layout_type;
+    return { field_array<Container, std::remove_cv_t<boost::pfr::tuple_element_t<I, U>>, L0 + leaf_offset<U, Layout, I>()>(container, pin)... };
+}
+
+template<typename Container, typename F, size_t L>
+ArrowArray* field_array(const Container& container, const std::shared_ptr<const void>& pin)
+{
+    if constexpr (Container::layout_type::template flatten<F>) {
+        return make_array(container.size(), pin, { nullptr }, field_arrays<Container, F, L>(container, pin, std::make_index_sequence<boost::pfr::tuple_size_v<F>>{}));
+    } else {
+        const auto& column = container.template leaf_column<L>();
+        static_assert(IsContiguous<std::decay_t<decltype(column)>>::value, "Only contiguous columns are exported");
+        if constexpr (IsStdArray<F>::value) {
+            const auto* values = reinterpret_cast<const typename F::value_type*>(column.data());
+            auto* items = make_array(container.size() * std::tuple_size_v<F>, pin, { nullptr, data_buffer(values) }, {});
+            return make_array(container.size(), pin, { nullptr }, { items });
+        } else {
+            return make_array(container.size(), pin, { nullptr, data_buffer(column.data()) }, {});
+        }
+    }
+}
+
+} // namespace arrow
+
+// Exports the type of SoA container as a struct of its fields. Names of top-level fields may be given,
+// the other fields are named by their indices ("f0", "f1", ...). The consumer must release the schema.
+template<typename Container>
+void export_arrow_schema(ArrowSchema* out, const std::vector<std::string>& names = {})
+{
+    using T = typename Container::value_type;
+    using Layout = typename Container::layout_type;
+    arrow::make_schema(out, "+s", "", arrow::field_schemas<T, Layout>(names, std::make_index_sequence<boost::pfr::tuple_size_v<T>>{}));
+}
+
+// Exports columns of the SoA container without copies. The array and each of its children
+// pin the container until they are released, so the container must not be modified meanwhile.
+template<typename Container>
+void export_arrow_array(std::shared_ptr<const Container> container, ArrowArray* out)
+{
+    using T = typename Container::value_type;
+    const std::shared_ptr<const void> pin = container;
+    auto* array = arrow::make_array(container->size(), pin, { nullptr },
+        arrow::field_arrays<Container, T, 0>(*container, pin, std::make_index_sequence<boost::pfr::tuple_size_v<T>>{}));
+    *out = *array;
+    delete array;
+}
+
+// Moves the container to the exported array; columns of vectors are moved without copies
+template<typename Container>
+void export_arrow(Container&& container, ArrowSchema* schema, ArrowArray* array, const std::vector<std::string>& names = {})
+{
+    using C = std::decay_t<Container>;
+    export_arrow_schema<C>(schema, names);
+    export_arrow_array(std::shared_ptr<const C>(std::make_shared<C>(std::forward<Container>(container))), array);
+}
+
+struct ConstSpanBinder
+{
+    template<typename U> using type = ColumnSpan<const U>;
+};
+
+// Read-only SoA view of an imported Arrow struct array. The array is moved into the view,
+// its buffers are used in place and released with the last copy of the view.
+// The schema must match T field by field; arrays with nulls are rejected.
+template<typename T, typename Layout = ShallowLayout>
+class ArrowSoAView : public RandomAccessContainer<SoARandomAccessContainer<T, ConstSpanBinder::template type, NoTracking, Layout>>
+{
+    using Fields = std::make_index_sequence<boost::pfr::tuple_size_v<T>>;
+public:
+    ArrowSoAView() = default;
+
+    ArrowSoAView(ArrowArray* array, const ArrowSchema* schema)
+    {
+        ArrowSchema expected;
+        arrow::make_schema(&expected, "+s", "", arrow::field_schemas<T, Layout>({}, Fields{}));
+        const bool compatible = matches(&expected, schema);
+        expected.release(&expected);
+        if (!compatible)
+            throw std::invalid_argument("Arrow schema does not match the structure");
+
+        // The array is moved only if it is accepted, otherwise the caller still owns it
+        length = size_t(array->length);
+        bind_struct<T, 0>(array, 0, Fields{});
+        owner = std::shared_ptr<ArrowArray>(new ArrowArray(*array), [](ArrowArray* a) {
+            if (a->release != nullptr)
+                a->release(a);
+            delete a;
+        });
+        array->release = nullptr;
+    }
+
+private:
+    static bool matches(const ArrowSchema* expected, const ArrowSchema* actual) noexcept
+    {
+        if (std::string(expected->format) != actual->format || expected->n_children != actual->n_children)
+            return false;
+        for (int64_t i = 0; i < expected->n_children; ++i)
+            if (!matches(expected->children[i], actual->children[i]))
+                return false;
+        return true;
+    }
+
+    // 'needed' is the number of elements of the node, which are referred by its parent
+    static void check(const ArrowArray* node, size_t needed)
+    {
+        if (node->null_count != 0 && node->buffers[0] != nullptr)
+            throw std::invalid_argument("Arrow arrays with nulls are not supported");
+        if (size_t(node->length) < needed)
+            throw std::invalid_argument("Arrow array is shorter than its parent");
+    }
+
+    // 'first' is the index of the first element in the parent's child, without the own offset
+    template<typename U, size_t L0, size_t ... I>
+    void bind_struct(const ArrowArray* node, size_t first, std::index_sequence<I...>)
+    {
+        check(node, first + length);
+        const size_t offset = first + size_t(node->offset);
+        ((void)bind_field<std::remove_cv_t<boost::pfr::tuple_element_t<I, U>>, L0 + arrow::leaf_offset<U, Layout, I>()>(node->children[I], offset), ...);
+    }
+
+    template<typename F, size_t L>
+    void bind_field(const ArrowArray* node, size_t first)
+    {
+        if constexpr (Layout::template flatten<F>) {
+            bind_struct<F, L>(node, first, std::make_index_sequence<boost::pfr::tuple_size_v<F>>{});
+        } else {
+            check(node, first + length);
+            const size_t offset = first + size_t(node->offset);
+            const F* values;
+            if constexpr (IsStdArray<F>::value) {
+                const ArrowArray* items = node->children[0];
+                check(items, (offset + length) * std::tuple_size_v<F>);
+                values = reinterpret_cast<const F*>(static_cast<const typename F::value_type*>(items->buffers[1]) + size_t(items->offset) + offset * std::tuple_size_v<F>);
+            } else {
+                values = static_cast<const F*>(node->buffers[1]) + offset;
+            }
+            std::get<L>(this->storage) = ColumnSpan<const F>(values, length);
+        }
+    }
+
+    std::shared_ptr<ArrowArray> owner;
+    size_t length = 0;
+};
+
 } // namespace aoaoaott
 
 #endif
@@ -25,7 +25,9 @@
 
 #include <iostream>
 #include <memory>
+#include <mutex>
 #include <new>
+#include <unordered_map>
 
 #define KB * 1024
 #define MB KB KB
@@ -143,6 +145,35 @@ static void Bytes12(benchmark::State& state)
     state.SetBytesProcessed(int64_t(state.iterations()) * iterations * sizeof(int32_t) * 3);
 }
 
+// The same kernel as Bytes12, written as a fused column expression, which is vectorized
+template<template<typename> typename Vector, typename A>
+static void Bytes12Expression(benchmark::State& state)
+{
+    Vector<A> storage(state.range(0) / sizeof(A));
+
+    for (auto _ : state) {
+        storage.template col<&A::x>() = storage.template col<&A::y>() << storage.template col<&A::z>();
+        benchmark::ClobberMemory();
+    }
+
+    state.SetBytesProcessed(int64_t(state.iterations()) * storage.size() * sizeof(int32_t) * 3);
+}
+
+// The same kernel as Bytes12, written explicitly for batches of 8 elements
+template<template<typename> typename Vector, typename A>
+static void Bytes12Batch(benchmark::State& state)
+{
+    Vector<A> storage(state.range(0) / sizeof(A));
+
+    for (auto _ : state) {
+        for (auto b : storage.template batches<8>())
+            b->*(&A::x) = (b->*(&A::y)) << (b->*(&A::z));
+        benchmark::ClobberMemory();
+    }
+
+    state.SetBytesProcessed(int64_t(state.iterations()) * storage.size() * sizeof(int32_t) * 3);
+}
+
 template<template<typename, size_t> typename Container, typename A, size_t INCREMENT>
 __attribute__((optimize("no-tree-vectorize")))
 static void AllBytes(benchmark::State& state)
@@ -162,6 +193,533 @@ static void AllBytes(benchmark::State& state)
     state.SetBytesProcessed(int64_t(state.iterations()) * iterations * sizeof(A));
 }
 
+template<template<typename, size_t> typename Container, typename A>
+static void FindValue(benchmark::State& state)
+{
+    auto storage = get_prepared_container<Container, A>();
+    storage->fill(A());
+
+    for (auto _ : state)
+        benchmark::DoNotOptimize(storage->template find<&A::x>(1));
+
+    state.SetBytesProcessed(int64_t(state.iterations()) * storage->size() * sizeof(int32_t));
+}
+
+template<template<typename, size_t> typename Container, typename A>
+static void SumValues(benchmark::State& state)
+{
+    auto storage = get_prepared_container<Container, A>();
+    storage->fill(A());
+
+    for (auto _ : state)
+        benchmark::DoNotOptimize(storage->template sum<&A::x>());
+
+    state.SetBytesProcessed(int64_t(state.iterations()) * storage->size() * sizeof(int32_t));
+}
+
+// Scans a field of a nested structure, which is a column of its own only in DeepSoAVector
+template<typename Vector>
+static void NestedScan(benchmark::State& state)
+{
+    Vector storage(state.range(0) / sizeof(A128));
+    for (size_t i = 0; i < storage.size(); ++i)
+        storage[i] = A128();
+
+    for (auto _ : state) {
+        const auto& column = storage.template column<&A128::a, &A64::x>();
+        benchmark::DoNotOptimize(aoaoaott::kernels::sum(aoaoaott::column_begin(column), storage.size(), int32_t{}));
+    }
+
+    state.SetBytesProcessed(int64_t(state.iterations()) * storage.size() * sizeof(int32_t));
+}
+
+struct Event
+{
+    int64_t timestamp;
+    int64_t value;
+    int32_t type;
+    int32_t flags;
+};
+
+static_assert(sizeof(Event) == 24);
+
+template<typename Vector>
+static auto get_events(size_t size)
+{
+    Vector storage;
+    storage.reserve(size);
+    for (size_t i = 0; i < size; ++i)
+        storage.push_back(Event{ int64_t(1'600'000'000'000 + i * 10 + i % 7), int64_t(i % 1000), int32_t(i % 5), 0 });
+    return storage;
+}
+
+// Scans of raw and encoded columns: deltas of timestamps, offsets of values, and a dictionary of types
+template<typename Vector>
+static void EncodedScan(benchmark::State& state)
+{
+    const auto storage = get_events<Vector>(state.range(0) / sizeof(Event));
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(storage.template sum<&Event::timestamp>());
+        benchmark::DoNotOptimize(storage.template sum<&Event::value>());
+        benchmark::DoNotOptimize(storage.template count<&Event::type>(3));
+    }
+
+    state.SetItemsProcessed(int64_t(state.iterations()) * storage.size());
+}
+
+template<typename Vector>
+static void FrozenEncodedScan(benchmark::State& state)
+{
+    const auto storage = get_events<Vector>(state.range(0) / sizeof(Event)).freeze();
+    state.counters["ratio"] = double(storage.size() * sizeof(Event)) / storage.memory_usage();
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(storage.template sum<&Event::timestamp>());
+        benchmark::DoNotOptimize(storage.template sum<&Event::value>());
+        benchmark::DoNotOptimize(storage.template count<&Event::type>(3));
+    }
+
+    state.SetItemsProcessed(int64_t(state.iterations()) * storage.size());
+}
+
+struct Entity
+{
+    int32_t id;
+    int32_t type;
+    int32_t flags;
+    std::array<char, 52> name;
+};
+
+struct EntityState
+{
+    int32_t id;
+    float x, y, z;
+    float vx, vy, vz;
+    int32_t state;
+};
+
+static_assert(sizeof(Entity) == 64);
+static_assert(sizeof(EntityState) == 32);
+
+// Counts entities by the first letter of the name
+template<typename Vector>
+static void NamePrefix(benchmark::State& state)
+{
+    Vector storage(state.range(0) / sizeof(Entity));
+    for (size_t i = 0; i < storage.size(); ++i)
+        storage[i] = Entity{ int32_t(i), 0, 0, { char('a' + i % 26) } };
+
+    for (auto _ : state) {
+        const auto& column = storage.template column<&Entity::name>(0);
+        benchmark::DoNotOptimize(aoaoaott::kernels::count(aoaoaott::column_begin(column), storage.size(), 'e'));
+    }
+
+    state.SetItemsProcessed(int64_t(state.iterations()) * storage.size());
+}
+
+template<template<typename> typename Vector>
+static void HashJoin(benchmark::State& state)
+{
+    const auto size = state.range(0);
+    Vector<Entity> entities(size);
+    Vector<EntityState> states(size);
+    for (int32_t i = 0; i < size; ++i) {
+        entities[i]->*(&Entity::id) = (i * 7919) % size;
+        entities[i]->*(&Entity::type) = i % 16;
+        states[i]->*(&EntityState::id) = i;
+        states[i]->*(&EntityState::x) = float(i);
+    }
+
+    for (auto _ : state) {
+        float result = 0;
+        aoaoaott::hash_join<&Entity::id, &EntityState::id>(entities, states, [&](auto entity, auto s) {
+            result += (entity->*(&Entity::type)) * (s->*(&EntityState::x));
+        });
+        benchmark::DoNotOptimize(result);
+    }
+
+    state.SetItemsProcessed(int64_t(state.iterations()) * size);
+}
+
+template<typename T>
+using SoAVector = aoaoaott::SoAVector<T>;
+
+template<typename T>
+using AoSVector = aoaoaott::AoSVector<T>;
+
+static std::vector<int32_t> get_random_keys(size_t size, size_t count)
+{
+    std::vector<int32_t> keys(count);
+    uint32_t seed = 1;
+    for (auto& key : keys) {
+        seed = seed * 1664525u + 1013904223u;
+        key = int32_t(seed % (2 * size));
+    }
+    return keys;
+}
+
+template<template<typename> typename Vector>
+static void LowerBound(benchmark::State& state)
+{
+    const size_t size = state.range(0) / sizeof(A64);
+    Vector<A64> storage(size);
+    for (size_t i = 0; i < size; ++i)
+        storage[i]->*(&A64::x) = int32_t(2 * i);
+
+    const auto keys = get_random_keys(size, 1024);
+    for (auto _ : state)
+        for (auto key : keys)
+            benchmark::DoNotOptimize(std::lower_bound(storage.begin(), storage.end(), key,
+                [](const auto& e, int32_t value) { return (e->*(&A64::x)) < value; }));
+
+    state.SetItemsProcessed(int64_t(state.iterations()) * keys.size());
+}
+
+static void EytzingerLowerBound(benchmark::State& state)
+{
+    const size_t size = state.range(0) / sizeof(A64);
+    aoaoaott::SoAVector<A64> storage(size);
+    for (size_t i = 0; i < size; ++i)
+        storage[i]->*(&A64::x) = int32_t(2 * i);
+
+    const aoaoaott::SortedSoATable<A64, &A64::x> table(storage);
+    const auto keys = get_random_keys(size, 1024);
+    for (auto _ : state)
+        for (auto key : keys)
+            benchmark::DoNotOptimize(table.lower_bound(key));
+
+    state.SetItemsProcessed(int64_t(state.iterations()) * keys.size());
+}
+
+// Point lookups of a single field in a table of large values; half of the keys are missing
+template<typename Map>
+static void HashLookup(benchmark::State& state)
+{
+    constexpr bool is_std = std::is_same_v<Map, std::unordered_map<int32_t, A128>>;
+    const size_t size = state.range(0);
+    Map map;
+    for (size_t i = 0; i < size; ++i) {
+        if constexpr (is_std)
+            map.emplace(int32_t(2 * i), A128{});
+        else
+            map.insert(int32_t(2 * i), A128{});
+    }
+
+    const auto keys = get_random_keys(2 * size, 16384);
+    for (auto _ : state) {
+        int32_t result = 0;
+        for (auto key : keys) {
+            if constexpr (is_std) {
+                auto it = map.find(key);
+                if (it != map.end())
+                    result += it->second.x;
+            }
+            else if (auto e = map.find(key)) {
+                result += *e->*(&A128::x);
+            }
+        }
+        benchmark::DoNotOptimize(result);
+    }
+
+    state.SetItemsProcessed(int64_t(state.iterations()) * keys.size());
+}
+
+template<typename T>
+using DeepSoAVector = aoaoaott::DeepSoAVector<T>;
+
+template<typename T>
+using TransposedSoAVector = aoaoaott::TransposedSoAVector<T>;
+
+template<typename K, typename V>
+using SoAHashMap = aoaoaott::SoAHashMap<K, V>;
+
+template<typename K, typename V>
+using AoSHashMap = aoaoaott::AoSHashMap<K, V>;
+
+// Sums two fields of elements chosen by a random index list, like an indirect join
+template<typename Vector, size_t DISTANCE>
+static void RandomGather(benchmark::State& state)
+{
+    Vector storage(state.range(0) / sizeof(A128));
+    for (size_t i = 0; i < storage.size(); ++i)
+        storage[i] = A128();
+
+    const auto indices = get_random_keys(storage.size() / 2, 1 << 16);
+    for (auto _ : state) {
+        int32_t sum = 0;
+        if constexpr (DISTANCE == 0) {
+            for (auto i : indices)
+                sum += (storage[i]->*(&A128::x)) + (storage[i]->*(&A128::y));
+        } else {
+            for (auto e : std::as_const(storage).template prefetching_at<&A128::x, &A128::y>(indices, DISTANCE))
+                sum += (e->*(&A128::x)) + (e->*(&A128::y));
+        }
+        benchmark::DoNotOptimize(sum);
+    }
+
+    state.SetItemsProcessed(int64_t(state.iterations()) * indices.size());
+}
+
+// Reads all fields of each element in order, which is a stream per leaf column of DeepSoAVector
+template<typename Vector, size_t DISTANCE>
+static void WideScan(benchmark::State& state)
+{
+    Vector storage(state.range(0) / sizeof(A128));
+    for (size_t i = 0; i < storage.size(); ++i)
+        storage[i] = A128();
+
+    for (auto _ : state) {
+        int32_t sum = 0;
+        if constexpr (DISTANCE == 0) {
+            for (const auto& e : std::as_const(storage))
+                sum += e.aggregate().sum();
+        } else {
+            for (auto e : std::as_const(storage).template prefetching<>(DISTANCE))
+                sum += e.aggregate().sum();
+        }
+        benchmark::DoNotOptimize(sum);
+    }
+
+    state.SetBytesProcessed(int64_t(state.iterations()) * storage.size() * sizeof(A128));
+}
+
+struct Cell
+{
+    float temperature;
+    float pressure;
+    int32_t material;
+    int32_t flags;
+};
+
+// 5-point stencil over a field of a square grid. Grids are traversed tile by tile,
+// and the only tile of a row-major grid is the whole grid. Cells of a tile row are consecutive
+// in all layouts, so neighbours are addressed by offsets from the starts of three rows.
+template<typename Grid>
+static void Stencil5(benchmark::State& state)
+{
+    const size_t side = state.range(0);
+    const Grid in(side, side, Cell{ 1.f, 0.f, 0, 0 });
+    Grid out(side, side);
+    const auto& t = in.cells().template column<&Cell::temperature>();
+    auto& cells = out.cells();
+
+    for (auto _ : state) {
+        in.for_each_tile([&](size_t x0, size_t y0, size_t x1, size_t y1) {
+            x0 = std::max<size_t>(x0, 1);
+            y0 = std::max<size_t>(y0, 1);
+            x1 = std::min(x1, side - 1);
+            y1 = std::min(y1, side - 1);
+            for (size_t y = y0; y < y1 && x0 < x1; ++y) {
+                const size_t row = in.index_of(x0, y), up = in.index_of(x0, y - 1), down = in.index_of(x0, y + 1);
+                const size_t n = x1 - x0;
+                auto update = [&](size_t k, float left, float right) {
+                    cells[row + k]->*(&Cell::temperature) = 0.2f * (t[row + k] + left + right + t[up + k] + t[down + k]);
+                };
+                update(0, t[in.index_of(x0 - 1, y)], n > 1 ? t[row + 1] : t[in.index_of(x1, y)]);
+                for (size_t k = 1; k + 1 < n; ++k)
+                    update(k, t[row + k - 1], t[row + k + 1]);
+                if (n > 1)
+                    update(n - 1, t[row + n - 2], t[in.index_of(x1, y)]);
+            }
+        });
+        benchmark::ClobberMemory();
+    }
+
+    state.SetItemsProcessed(int64_t(state.iterations()) * (side - 2) * (side - 2));
+}
+
+// Exports a table to Arrow and releases it, which does not depend on the number of rows
+static void ArrowExport(benchmark::State& state)
+{
+    const auto storage = std::make_shared<aoaoaott::DeepSoAVector<A128>>(state.range(0) / sizeof(A128));
+    for (auto _ : state) {
+        ArrowArray array;
+        aoaoaott::export_arrow_array<aoaoaott::DeepSoAVector<A128>>(storage, &array);
+        benchmark::DoNotOptimize(array.children[0]->children[0]->buffers[1]);
+        array.release(&array);
+    }
+
+    state.SetBytesProcessed(int64_t(state.iterations()) * storage->size() * sizeof(A128));
+}
+
+// Overwrites the container with a value, with regular or with non-temporal stores
+template<typename Vector, bool STREAMING>
+static void BulkAssign(benchmark::State& state)
+{
+    const size_t threshold = aoaoaott::streaming_threshold.exchange(STREAMING ? 0 : SIZE_MAX);
+    Vector storage(state.range(0) / sizeof(A64));
+    for (auto _ : state) {
+        storage.assign(storage.size(), A64());
+        benchmark::ClobberMemory();
+    }
+    aoaoaott::streaming_threshold = threshold;
+
+    state.SetBytesProcessed(int64_t(state.iterations()) * storage.size() * sizeof(A64));
+}
+
+// Converts between layouts, with regular or with non-temporal stores
+template<typename Vector, typename Source, bool STREAMING>
+static void BulkConvert(benchmark::State& state)
+{
+    const size_t threshold = aoaoaott::streaming_threshold.exchange(STREAMING ? 0 : SIZE_MAX);
+    Source source(state.range(0) / sizeof(A64));
+    Vector storage(source.size());
+    for (auto _ : state) {
+        storage.assign(source);
+        benchmark::ClobberMemory();
+    }
+    aoaoaott::streaming_threshold = threshold;
+
+    state.SetBytesProcessed(int64_t(state.iterations()) * storage.size() * sizeof(A64));
+}
+
+// Takes a snapshot for readers and updates a single field, like a simulation tick
+template<typename Vector>
+static void SnapshotAndWrite(benchmark::State& state)
+{
+    const size_t size = state.range(0) / sizeof(A64);
+    Vector storage(size);
+    size_t i = 0;
+    for (auto _ : state) {
+        auto snapshot = std::make_shared<const Vector>(storage);
+        storage[i++ % size]->*(&A64::x) += 1;
+        benchmark::DoNotOptimize(snapshot);
+    }
+
+    state.SetBytesProcessed(int64_t(state.iterations()) * size * sizeof(A64));
+}
+
+template<typename T>
+using CowSoAVector = aoaoaott::CowSoAVector<T>;
+
+template<typename T>
+using BlockCowSoAVector = aoaoaott::CowSoAVector<T, 4096>;
+
+// Appends to a vector without reservation, so SoAVector reallocates and copies all columns on growth
+template<typename Vector>
+static void PushBackGrowth(benchmark::State& state)
+{
+    const size_t size = state.range(0) / sizeof(A64);
+    for (auto _ : state) {
+        Vector storage;
+        for (size_t i = 0; i < size; ++i)
+            storage.push_back(A64{ {}, int32_t(i), 0, 0, 0 });
+        benchmark::DoNotOptimize(storage.size());
+    }
+
+    state.SetItemsProcessed(int64_t(state.iterations()) * size);
+}
+
+template<typename T>
+using SegmentedSoAVector = aoaoaott::SegmentedSoAVector<T>;
+
+template<typename T>
+using SegmentedAoSVector = aoaoaott::SegmentedAoSVector<T>;
+
+// Builds many per-entity sub-tables, which hold fewer elements than the inline capacity
+template<typename Vector>
+static void SmallTables(benchmark::State& state)
+{
+    const size_t tables = 1024;
+    const size_t size = state.range(0);
+    for (auto _ : state) {
+        std::vector<Vector> storage(tables);
+        int32_t result = 0;
+        for (auto& table : storage) {
+            for (size_t i = 0; i < size; ++i)
+                table.push_back(A16{ int32_t(i), 0, 0, 0 });
+            result += table.template sum<&A16::x>();
+        }
+        benchmark::DoNotOptimize(result);
+    }
+
+    state.SetItemsProcessed(int64_t(state.iterations()) * tables * size);
+}
+
+template<typename T>
+using SmallSoAVector = aoaoaott::SmallSoAVector<T, 32>;
+
+template<typename T>
+using SmallAoSVector = aoaoaott::SmallAoSVector<T, 32>;
+
+// Passes batches of records between pipeline stages, the consumer reads a single field
+static void VectorQueueBatch(benchmark::State& state)
+{
+    const size_t batch = state.range(0);
+    const std::vector<A64> input(batch);
+    std::vector<A64> queue;
+    for (auto _ : state) {
+        queue.insert(queue.end(), input.begin(), input.end());
+        int32_t result = 0;
+        for (const auto& e : queue)
+            result += e.x;
+        queue.clear();
+        benchmark::DoNotOptimize(result);
+    }
+
+    state.SetItemsProcessed(int64_t(state.iterations()) * batch);
+}
+
+static void RingBufferBatch(benchmark::State& state)
+{
+    const size_t batch = state.range(0);
+    const std::vector<A64> input(batch);
+    auto ring = std::make_unique<aoaoaott::SoARingBuffer<A64, 4096>>();
+    for (auto _ : state) {
+        ring->push(input.begin(), input.end());
+        int32_t result = 0;
+        for (auto view = ring->peek(); !view.empty(); view = ring->peek()) {
+            for (auto x : view.column<&A64::x>())
+                result += x;
+            ring->consume(view.size());
+        }
+        benchmark::DoNotOptimize(result);
+    }
+
+    state.SetItemsProcessed(int64_t(state.iterations()) * batch);
+}
+
+// Many producers append to a single table, the baseline wraps push_back into a mutex
+template<typename Vector>
+static void LockedPushBack(benchmark::State& state)
+{
+    static Vector* storage;
+    static std::mutex mutex;
+    if (state.thread_index() == 0)
+        storage = new Vector;
+
+    int32_t i = 0;
+    for (auto _ : state) {
+        std::lock_guard<std::mutex> lock(mutex);
+        storage->push_back(A16{ i++, state.thread_index(), 0, 0 });
+    }
+
+    if (state.thread_index() == 0)
+        delete storage;
+    state.SetItemsProcessed(state.iterations());
+}
+
+template<typename Vector>
+static void ConcurrentPushBack(benchmark::State& state)
+{
+    static Vector* storage;
+    if (state.thread_index() == 0)
+        storage = new Vector;
+
+    int32_t i = 0;
+    for (auto _ : state)
+        storage->push_back(A16{ i++, state.thread_index(), 0, 0 });
+
+    if (state.thread_index() == 0)
+        delete storage;
+    state.SetItemsProcessed(state.iterations());
+}
+
+template<typename T>
+using ConcurrentSoAVector = aoaoaott::ConcurrentSoAVector<T>;
+
+template<typename T>
+using ConcurrentAoSVector = aoaoaott::ConcurrentAoSVector<T>;
+
 template<typename T, size_t N>
 using SoA = aoaoaott::SoAArray<T, N>;
 
@@ -233,5 +791,107 @@ BENCHMARK_TEMPLATE(AllBytes, AoS, A68, 16)->Arg(1 MB);
 BENCHMARK_TEMPLATE(AllBytes, AoS, A96, 16)->Arg(1 MB);
 BENCHMARK_TEMPLATE(AllBytes, AoS, A128, 16)->Arg(1 MB);
 
+BENCHMARK_TEMPLATE(Bytes12Expression, SoAVector, A12)->Arg(16 KB)->Arg(64 KB)->Arg(1 MB)->Arg(4 MB);
+BENCHMARK_TEMPLATE(Bytes12Expression, SoAVector, A64)->Arg(16 KB)->Arg(64 KB)->Arg(1 MB)->Arg(4 MB);
+BENCHMARK_TEMPLATE(Bytes12Expression, SoAVector, A128)->Arg(16 KB)->Arg(64 KB)->Arg(1 MB)->Arg(4 MB);
+BENCHMARK_TEMPLATE(Bytes12Expression, AoSVector, A12)->Arg(16 KB)->Arg(64 KB)->Arg(1 MB)->Arg(4 MB);
+BENCHMARK_TEMPLATE(Bytes12Expression, AoSVector, A64)->Arg(16 KB)->Arg(64 KB)->Arg(1 MB)->Arg(4 MB);
+BENCHMARK_TEMPLATE(Bytes12Expression, AoSVector, A128)->Arg(16 KB)->Arg(64 KB)->Arg(1 MB)->Arg(4 MB);
+
+BENCHMARK_TEMPLATE(Bytes12Batch, SoAVector, A12)->Arg(16 KB)->Arg(64 KB)->Arg(1 MB)->Arg(4 MB);
+BENCHMARK_TEMPLATE(Bytes12Batch, SoAVector, A64)->Arg(16 KB)->Arg(64 KB)->Arg(1 MB)->Arg(4 MB);
+BENCHMARK_TEMPLATE(Bytes12Batch, AoSVector, A12)->Arg(16 KB)->Arg(64 KB)->Arg(1 MB)->Arg(4 MB);
+BENCHMARK_TEMPLATE(Bytes12Batch, AoSVector, A64)->Arg(16 KB)->Arg(64 KB)->Arg(1 MB)->Arg(4 MB);
+
+BENCHMARK_TEMPLATE(FindValue, SoA, A12);
+BENCHMARK_TEMPLATE(FindValue, SoA, A16);
+BENCHMARK_TEMPLATE(FindValue, SoA, A64);
+BENCHMARK_TEMPLATE(FindValue, SoA, A128);
+BENCHMARK_TEMPLATE(FindValue, AoS, A12);
+BENCHMARK_TEMPLATE(FindValue, AoS, A16);
+BENCHMARK_TEMPLATE(FindValue, AoS, A64);
+BENCHMARK_TEMPLATE(FindValue, AoS, A128);
+
+BENCHMARK_TEMPLATE(SumValues, SoA, A12);
+BENCHMARK_TEMPLATE(SumValues, SoA, A16);
+BENCHMARK_TEMPLATE(SumValues, SoA, A64);
+BENCHMARK_TEMPLATE(SumValues, SoA, A128);
+BENCHMARK_TEMPLATE(SumValues, AoS, A12);
+BENCHMARK_TEMPLATE(SumValues, AoS, A16);
+BENCHMARK_TEMPLATE(SumValues, AoS, A64);
+BENCHMARK_TEMPLATE(SumValues, AoS, A128);
+
+BENCHMARK_TEMPLATE(NestedScan, SoAVector<A128>)->Arg(1 MB)->Arg(64 MB);
+BENCHMARK_TEMPLATE(NestedScan, DeepSoAVector<A128>)->Arg(1 MB)->Arg(64 MB);
+BENCHMARK_TEMPLATE(NestedScan, AoSVector<A128>)->Arg(1 MB)->Arg(64 MB);
+
+BENCHMARK_TEMPLATE(NamePrefix, SoAVector<Entity>)->Arg(1 MB)->Arg(64 MB);
+BENCHMARK_TEMPLATE(NamePrefix, TransposedSoAVector<Entity>)->Arg(1 MB)->Arg(64 MB);
+BENCHMARK_TEMPLATE(NamePrefix, AoSVector<Entity>)->Arg(1 MB)->Arg(64 MB);
+
+BENCHMARK_TEMPLATE(EncodedScan, SoAVector<Event>)->Arg(1 MB)->Arg(64 MB);
+BENCHMARK_TEMPLATE(FrozenEncodedScan, SoAVector<Event>)->Arg(1 MB)->Arg(64 MB);
+
+BENCHMARK_TEMPLATE(HashJoin, SoAVector)->Arg(16 KB)->Arg(1 MB);
+BENCHMARK_TEMPLATE(HashJoin, AoSVector)->Arg(16 KB)->Arg(1 MB);
+
+BENCHMARK_TEMPLATE(LowerBound, SoAVector)->Arg(64 KB)->Arg(4 MB)->Arg(64 MB);
+BENCHMARK_TEMPLATE(LowerBound, AoSVector)->Arg(64 KB)->Arg(4 MB)->Arg(64 MB);
+BENCHMARK_TEMPLATE(HashLookup, std::unordered_map<int32_t, A128>)->Arg(16 KB)->Arg(256 KB);
+BENCHMARK_TEMPLATE(HashLookup, SoAHashMap<int32_t, A128>)->Arg(16 KB)->Arg(256 KB);
+BENCHMARK_TEMPLATE(HashLookup, AoSHashMap<int32_t, A128>)->Arg(16 KB)->Arg(256 KB);
+
+BENCHMARK_TEMPLATE(RandomGather, SoAVector<A128>, 0)->Arg(1 MB)->Arg(64 MB)->Arg(512 MB);
+BENCHMARK_TEMPLATE(RandomGather, SoAVector<A128>, 16)->Arg(1 MB)->Arg(64 MB)->Arg(512 MB);
+BENCHMARK_TEMPLATE(RandomGather, AoSVector<A128>, 0)->Arg(1 MB)->Arg(64 MB)->Arg(512 MB);
+BENCHMARK_TEMPLATE(RandomGather, AoSVector<A128>, 16)->Arg(1 MB)->Arg(64 MB)->Arg(512 MB);
+
+BENCHMARK_TEMPLATE(WideScan, DeepSoAVector<A128>, 0)->Arg(1 MB)->Arg(64 MB);
+BENCHMARK_TEMPLATE(WideScan, DeepSoAVector<A128>, 8)->Arg(1 MB)->Arg(64 MB);
+BENCHMARK_TEMPLATE(WideScan, AoSVector<A128>, 0)->Arg(1 MB)->Arg(64 MB);
+BENCHMARK_TEMPLATE(WideScan, AoSVector<A128>, 8)->Arg(1 MB)->Arg(64 MB);
+
+BENCHMARK_TEMPLATE(Stencil5, aoaoaott::AoSGrid2D<Cell>)->Arg(1024)->Arg(4096);
+BENCHMARK_TEMPLATE(Stencil5, aoaoaott::SoAGrid2D<Cell>)->Arg(1024)->Arg(4096);
+BENCHMARK_TEMPLATE(Stencil5, aoaoaott::TiledAoSGrid2D<Cell>)->Arg(1024)->Arg(4096);
+BENCHMARK_TEMPLATE(Stencil5, aoaoaott::TiledSoAGrid2D<Cell>)->Arg(1024)->Arg(4096);
+BENCHMARK_TEMPLATE(Stencil5, aoaoaott::TiledSoAGrid2D<Cell, 8>)->Arg(1024)->Arg(4096);
+
+BENCHMARK(ArrowExport)->Arg(1 MB)->Arg(64 MB);
+
+BENCHMARK_TEMPLATE(BulkAssign, SoAVector<A64>, false)->Arg(64 MB)->Arg(256 MB);
+BENCHMARK_TEMPLATE(BulkAssign, SoAVector<A64>, true)->Arg(64 MB)->Arg(256 MB);
+BENCHMARK_TEMPLATE(BulkAssign, AoSVector<A64>, false)->Arg(64 MB)->Arg(256 MB);
+BENCHMARK_TEMPLATE(BulkAssign, AoSVector<A64>, true)->Arg(64 MB)->Arg(256 MB);
+
+BENCHMARK_TEMPLATE(BulkConvert, SoAVector<A64>, AoSVector<A64>, false)->Arg(64 MB)->Arg(256 MB);
+BENCHMARK_TEMPLATE(BulkConvert, SoAVector<A64>, AoSVector<A64>, true)->Arg(64 MB)->Arg(256 MB);
+BENCHMARK_TEMPLATE(BulkConvert, AoSVector<A64>, SoAVector<A64>, false)->Arg(64 MB)->Arg(256 MB);
+BENCHMARK_TEMPLATE(BulkConvert, AoSVector<A64>, SoAVector<A64>, true)->Arg(64 MB)->Arg(256 MB);
+
+BENCHMARK_TEMPLATE(SnapshotAndWrite, SoAVector<A64>)->Arg(1 MB)->Arg(64 MB);
+BENCHMARK_TEMPLATE(SnapshotAndWrite, CowSoAVector<A64>)->Arg(1 MB)->Arg(64 MB);
+BENCHMARK_TEMPLATE(SnapshotAndWrite, BlockCowSoAVector<A64>)->Arg(1 MB)->Arg(64 MB);
+
+BENCHMARK(EytzingerLowerBound)->Arg(64 KB)->Arg(4 MB)->Arg(64 MB);
+
+BENCHMARK_TEMPLATE(PushBackGrowth, SoAVector<A64>)->Arg(1 MB)->Arg(64 MB);
+BENCHMARK_TEMPLATE(PushBackGrowth, SegmentedSoAVector<A64>)->Arg(1 MB)->Arg(64 MB);
+BENCHMARK_TEMPLATE(PushBackGrowth, AoSVector<A64>)->Arg(1 MB)->Arg(64 MB);
+BENCHMARK_TEMPLATE(PushBackGrowth, SegmentedAoSVector<A64>)->Arg(1 MB)->Arg(64 MB);
+
+BENCHMARK_TEMPLATE(SmallTables, SoAVector<A16>)->Arg(4)->Arg(20);
+BENCHMARK_TEMPLATE(SmallTables, SmallSoAVector<A16>)->Arg(4)->Arg(20);
+BENCHMARK_TEMPLATE(SmallTables, AoSVector<A16>)->Arg(4)->Arg(20);
+BENCHMARK_TEMPLATE(SmallTables, SmallAoSVector<A16>)->Arg(4)->Arg(20);
+
+BENCHMARK(VectorQueueBatch)->Arg(64)->Arg(1024);
+BENCHMARK(RingBufferBatch)->Arg(64)->Arg(1024);
+
+BENCHMARK_TEMPLATE(LockedPushBack, SoAVector<A16>)->Iterations(1 << 20)->ThreadRange(1, 8)->UseRealTime();
+BENCHMARK_TEMPLATE(LockedPushBack, AoSVector<A16>)->Iterations(1 << 20)->ThreadRange(1, 8)->UseRealTime();
+BENCHMARK_TEMPLATE(ConcurrentPushBack, ConcurrentSoAVector<A16>)->Iterations(1 << 20)->ThreadRange(1, 8)->UseRealTime();
+BENCHMARK_TEMPLATE(ConcurrentPushBack, ConcurrentAoSVector<A16>)->Iterations(1 << 20)->ThreadRange(1, 8)->UseRealTime();
+
 BENCHMARK_MAIN();
 
@@ -30,7 +30,9 @@
 #endif
 
 #include <boost/test/included/unit_test.hpp>
+#include <cmath>
 #include <cstring>
+#include <numeric>
 
 #define PASTER(x,y) x ## y
 #define EVALUATOR(x,y) PASTER(x,y)
@@ -71,13 +73,10 @@ struct A {
     int dum;
 };
 
-/*
-static const constexpr ARRAY_CONTAINER<A, 11> array = {};
-static const constexpr size_t distance = bold_cast(array[10].get<&A::key>()) - bold_cast(array[0].get<&A::key>());
-static_assert(std::is_same_v<decltype(array), AoSArray<A, 11>>
-                ? distance == 10 * sizeof(A)
-                : distance == 10 * sizeof(int));
-*/
+static constexpr ARRAY_CONTAINER<A, 11> constant_array({ A{1, 2, 3}, A{4, 5, 6} });
+static_assert((constant_array[1]->*(&A::key)) == 5);
+static_assert(constant_array[10].get<&A::dum>() == 0);
+static_assert(constant_array.size() == 11);
 
 BOOST_AUTO_TEST_CASE(initialize_and_rw)
 {
@@ -310,6 +309,74 @@ BOOST_AUTO_TEST_CASE(random_access_iterator)
     BOOST_TEST((storage.begin() <= storage.end()));
     auto it = std::next(storage.begin(), 60);
     BOOST_TEST((storage.end() - it) == 30 );
+
+    for (size_t i = 0; i < storage.size(); ++i)
+        storage[i]->*(&A::key) = int(i);
+    it = std::lower_bound(storage.begin(), storage.end(), 42, [](const auto& e, int v) { return (e->*(&A::key)) < v; });
+    BOOST_TEST((it - storage.begin()) == 42 );
+}
+
+// Mutable iterators are copied and assigned like pointers, while assignment of facades writes elements
+template<typename Container>
+static void check_iterator_assignment(Container& storage, Container& other)
+{
+    for (size_t i = 0; i < storage.size(); ++i) {
+        storage[i]->*(&A::key) = int(2 * i);
+        other[i]->*(&A::key) = int(2 * i + 1);
+    }
+
+    typename Container::iterator it = storage.begin();
+    auto copy = it;
+    it = std::next(other.begin(), 3);
+    BOOST_TEST( (*copy->*(&A::key)) == 0 );
+    BOOST_TEST( (*it->*(&A::key)) == 7 );
+    copy = it;
+    BOOST_TEST( (copy == it) );
+    BOOST_TEST( (storage[0]->*(&A::key)) == 0 );
+    BOOST_TEST( (other[3]->*(&A::key)) == 7 );
+
+    auto less = [](const auto& e, int v) { return (e->*(&A::key)) < v; };
+    it = std::lower_bound(storage.begin(), storage.end(), 42, less);
+    BOOST_TEST( (it - storage.begin()) == 21 );
+    it = std::lower_bound(other.begin(), other.end(), 42, less);
+    BOOST_TEST( (it - other.begin()) == 21 );
+    BOOST_TEST( (*it->*(&A::key)) == 43 );
+    it = std::lower_bound(storage.begin(), storage.end(), 1000, less);
+    BOOST_TEST( (it == storage.end()) );
+
+    auto cit = std::lower_bound(std::as_const(storage).begin(), std::as_const(storage).end(), 43, less);
+    BOOST_TEST( (*cit->*(&A::key)) == 44 );
+}
+
+BOOST_AUTO_TEST_CASE(iterator_assignment)
+{
+    constexpr bool soa = std::is_same_v<VECTOR_CONTAINER<A>, SoAVector<A>>;
+    {
+        VECTOR_CONTAINER<A> storage(64), other(64);
+        check_iterator_assignment(storage, other);
+    }
+    {
+        ARRAY_CONTAINER<A, 64> storage, other;
+        check_iterator_assignment(storage, other);
+    }
+    {
+        VECTOR_CONTAINER<A, std::allocator, DirtyTracking<16>> storage(64), other(64);
+        check_iterator_assignment(storage, other);
+    }
+    {
+        std::conditional_t<soa, SegmentedSoAVector<A, 16>, SegmentedAoSVector<A, 16>> storage(64), other(64);
+        check_iterator_assignment(storage, other);
+    }
+    {
+        std::conditional_t<soa, SmallSoAVector<A, 8>, SmallAoSVector<A, 8>> storage(64), other(64);
+        check_iterator_assignment(storage, other);
+    }
+    if constexpr (soa) {
+        CowSoAVector<A> storage(64), other(64);
+        check_iterator_assignment(storage, other);
+        DeepSoAVector<A> deep(64), deep_other(64);
+        check_iterator_assignment(deep, deep_other);
+    }
 }
 
 BOOST_AUTO_TEST_CASE(reverse_iterator)
@@ -330,6 +397,35 @@ BOOST_AUTO_TEST_CASE(reverse_iterator)
     }
 }
 
+// Reverse iterators dereference to facades they own, which std::reverse_iterator would leave dangling
+template<typename Container>
+static void check_reverse_range(Container& storage)
+{
+    int value = 0;
+    for (auto it = storage.rbegin(); it != storage.rend(); ++it)
+        *it = A{ ++value, -value, 0 };
+    BOOST_TEST( (storage[0]->*(&A::val)) == int(storage.size()) );
+    BOOST_TEST( (storage[storage.size() - 1]->*(&A::key)) == -1 );
+    BOOST_TEST( (storage.rend() - storage.rbegin()) == ptrdiff_t(storage.size()) );
+
+    auto found = std::find_if(std::as_const(storage).rbegin(), std::as_const(storage).rend(), [](const auto& e) { return (e->*(&A::val)) == 3; });
+    BOOST_TEST( (std::as_const(storage).rend() - found) == ptrdiff_t(storage.size()) - 2 );
+    auto last = std::prev(storage.rend());
+    BOOST_TEST( (*last->*(&A::val)) == int(storage.size()) );
+}
+
+BOOST_AUTO_TEST_CASE(reverse_iterator_range)
+{
+    VECTOR_CONTAINER<A> storage(10);
+    check_reverse_range(storage);
+    ARRAY_CONTAINER<A, 7> array;
+    check_reverse_range(array);
+
+    VECTOR_CONTAINER<A> empty;
+    BOOST_TEST( (empty.rbegin() == empty.rend()) );
+    BOOST_TEST( (std::as_const(empty).rbegin() == std::as_const(empty).rend()) );
+}
+
 BOOST_AUTO_TEST_CASE(const_method)
 {
     const VECTOR_CONTAINER<HasMethod> storage( 10, HasMethod{33, 44});
@@ -355,6 +451,18 @@ BOOST_AUTO_TEST_CASE(const_method_and_mutable_field)
     const VECTOR_CONTAINER<HasMutable> storage( 10, HasMutable{109});
     storage[3].method<&HasMutable::update_x>();
     BOOST_TEST( (storage[3]->*(&HasMutable::x)) == 110 );
+
+    ARRAY_CONTAINER<HasMutable, 4> array;
+    array[1].method<&HasMutable::update_x>();
+    (array[1]->*(&HasMutable::update_x))();
+    BOOST_TEST( (array[1]->*(&HasMutable::x)) == 2 );
+}
+
+BOOST_AUTO_TEST_CASE(const_array_method)
+{
+    const ARRAY_CONTAINER<HasMethod, 4> storage({ HasMethod{33, 44}, HasMethod{1, 2} });
+    BOOST_TEST( (storage[0]->*(&HasMethod::drink_cologne))(1) == 80 );
+    BOOST_TEST( storage[1].method<&HasMethod::drink_cologne>(2) == 9 );
 }
 
 BOOST_AUTO_TEST_CASE(arrow_star_method)
@@ -423,8 +531,1348 @@ BOOST_AUTO_TEST_CASE(vector_assign)
 {
     VECTOR_CONTAINER<A> storage(10, A{3, 14, 15});
     storage.assign(5, A{2, 7, 1828});
-    BOOST_TEST( (storage[7]->*(&A::dum)) == 15 );
     BOOST_TEST( (storage[2]->*(&A::dum)) == 1828 );
+
+    // Like std::vector::assign, the size becomes the count, so smaller assignments shrink
+    BOOST_TEST( storage.size() == 5 );
+    BOOST_TEST( (storage[4]->*(&A::key)) == 7 );
+    storage.assign(8, A{1, 2, 3});
+    BOOST_TEST( storage.size() == 8 );
+    BOOST_TEST( (storage[7]->*(&A::dum)) == 3 );
+    storage.assign(0, A{1, 2, 3});
+    BOOST_TEST( storage.empty() );
+}
+
+BOOST_AUTO_TEST_CASE(vector_erase_if)
+{
+    VECTOR_CONTAINER<A> storage;
+    for (int i = 0; i < 10; ++i)
+        storage.push_back(A{i, 10 * i, 100 * i});
+
+    BOOST_TEST( storage.erase_if<&A::val>([](int val) { return val % 3 == 0; }) == 4 );
+    BOOST_TEST( storage.size() == 6 );
+    BOOST_TEST( (storage[0]->*(&A::key)) == 10 );
+    BOOST_TEST( (storage[2]->*(&A::dum)) == 400 );
+    BOOST_TEST( (storage[5]->*(&A::val)) == 8 );
+
+    BOOST_TEST( (storage.erase_if<&A::val, &A::key>([](int val, int key) { return val + key == 22; })) == 1 );
+    BOOST_TEST( storage.size() == 5 );
+    BOOST_TEST( (storage[0]->*(&A::val)) == 1 );
+    BOOST_TEST( (storage[1]->*(&A::val)) == 4 );
+
+    BOOST_TEST( storage.erase_if<&A::dum>([](int) { return false; }) == 0 );
+    BOOST_TEST( storage.size() == 5 );
+}
+
+struct Measure {
+    int64_t id;
+    double weight;
+    int32_t count;
+    float ratio;
+};
+
+struct Pair {
+    int first;
+    int second;
+};
+
+BOOST_AUTO_TEST_CASE(vector_erase_if_vectorized)
+{
+    // Columns of 4- and 8-byte types are packed by vectors, with scalar tails
+    VECTOR_CONTAINER<Measure> storage;
+    VECTOR_CONTAINER<Pair> pairs;
+    std::vector<int64_t> expected;
+    for (int i = 0; i < 1003; ++i) {
+        storage.push_back(Measure{ i, i * 0.5, -i, i * 0.25f });
+        pairs.push_back(Pair{ i, -i });
+        if (i % 7 != 3 && i % 5 != 1 && (i < 300 || i > 340))
+            expected.push_back(i);
+    }
+
+    auto erased = [](int64_t id) { return id % 7 == 3 || id % 5 == 1 || (id >= 300 && id <= 340); };
+    BOOST_TEST( storage.erase_if<&Measure::id>(erased) == 1003 - expected.size() );
+    BOOST_TEST( pairs.erase_if<&Pair::first>(erased) == 1003 - expected.size() );
+    BOOST_TEST( storage.size() == expected.size() );
+    BOOST_TEST( pairs.size() == expected.size() );
+    bool packed = true;
+    for (size_t i = 0; i < expected.size(); ++i) {
+        const auto id = expected[i];
+        packed &= (storage[i]->*(&Measure::id)) == id && (storage[i]->*(&Measure::weight)) == id * 0.5;
+        packed &= (storage[i]->*(&Measure::count)) == -id && (storage[i]->*(&Measure::ratio)) == id * 0.25f;
+        packed &= (pairs[i]->*(&Pair::first)) == id && (pairs[i]->*(&Pair::second)) == -id;
+    }
+    BOOST_TEST( packed );
+
+    BOOST_TEST( storage.erase_if<&Measure::count>([](int32_t) { return true; }) == expected.size() );
+    BOOST_TEST( storage.empty() );
+}
+
+struct NoSelfAssignment {
+    int value;
+    NoSelfAssignment& operator=(const NoSelfAssignment& rhs)
+    {
+        BOOST_TEST( this != &rhs );
+        value = rhs.value;
+        return *this;
+    }
+};
+
+struct WithNoSelfAssignment {
+    NoSelfAssignment x;
+    int y;
+};
+
+BOOST_AUTO_TEST_CASE(vector_erase_if_without_self_assignment)
+{
+    VECTOR_CONTAINER<WithNoSelfAssignment> storage;
+    for (int i = 0; i < 10; ++i)
+        storage.push_back(WithNoSelfAssignment{ { i}, i});
+
+    BOOST_TEST( storage.erase_if<&WithNoSelfAssignment::y>([](int y) { return y == 2 || y == 5; }) == 2 );
+    BOOST_TEST( storage.size() == 8 );
+    BOOST_TEST( (storage[2].get<&WithNoSelfAssignment::x, &NoSelfAssignment::value>()) == 3 );
+    BOOST_TEST( (storage[7]->*(&WithNoSelfAssignment::y)) == 9 );
+}
+
+BOOST_AUTO_TEST_CASE(column_algorithms)
+{
+    VECTOR_CONTAINER<A> storage;
+    for (int i = 0; i < 37; ++i)
+        storage.push_back(A{i, (i * 7) % 37 - 18, 5});
+
+    BOOST_TEST( (storage.find<&A::val>(29) - storage.begin()) == 29 );
+    BOOST_TEST( (storage.find<&A::val>(100) == storage.end()) );
+    BOOST_TEST( storage.find<&A::key>(-18)->get<&A::val>() == 0 );
+    BOOST_TEST( storage.count<&A::dum>(5) == 37 );
+    BOOST_TEST( storage.count<&A::key>(0) == 1 );
+    BOOST_TEST( storage.min<&A::key>() == -18 );
+    BOOST_TEST( storage.max<&A::key>() == 18 );
+    BOOST_TEST( (storage.minmax<&A::val>() == std::pair<int, int>(0, 36)) );
+    BOOST_TEST( storage.sum<&A::val>() == 666 );
+    BOOST_TEST( storage.sum<&A::dum>(int64_t{ 1}) == 186 );
+    BOOST_TEST( storage.sum<&A::dum>(short{ 1}) == 186 );
+    BOOST_TEST( storage.any_of<&A::key>([](int key) { return key > 17; }) );
+    BOOST_TEST( !storage.any_of<&A::key>([](int key) { return key > 18; }) );
+
+    const auto& const_ref = storage;
+    BOOST_TEST( const_ref.find<&A::val>(3)->get<&A::key>() == 3 );
+}
+
+BOOST_AUTO_TEST_CASE(column_algorithms_float)
+{
+    struct Particle {
+        float x;
+        float y;
+    };
+
+    ARRAY_CONTAINER<Particle, 21> storage;
+    for (size_t i = 0; i < storage.size(); ++i)
+        storage[i] = Particle{ float(i) / 2, 20.f - i};
+
+    BOOST_TEST( (storage.find<&Particle::x>(7.5f) - storage.begin()) == 15 );
+    BOOST_TEST( storage.count<&Particle::y>(0.f) == 1 );
+    BOOST_TEST( storage.min<&Particle::y>() == 0.f );
+    BOOST_TEST( storage.max<&Particle::x>() == 10.f );
+    BOOST_TEST( storage.sum<&Particle::x>() == 105.f );
+
+    // NaNs are ignored by SIMD and scalar kernels alike, wherever they are
+    const float nan = std::numeric_limits<float>::quiet_NaN();
+    for (size_t position : { size_t{0}, size_t{3}, size_t{9}, size_t{20} }) {
+        storage[position]->*(&Particle::y) = nan;
+        const auto range = storage.minmax<&Particle::y>();
+        BOOST_TEST( range.first == (position == 20 ? 1.f : 0.f), "NaN at " << position );
+        BOOST_TEST( range.second == (position == 0 ? 19.f : 20.f), "NaN at " << position );
+        storage[position]->*(&Particle::y) = 20.f - position;
+    }
+    for (size_t i = 0; i < 16; ++i)
+        storage[i]->*(&Particle::y) = nan;
+    BOOST_TEST( (storage.minmax<&Particle::y>() == std::pair<float, float>(0.f, 4.f)) );
+    for (size_t i = 16; i < storage.size(); ++i)
+        storage[i]->*(&Particle::y) = nan;
+    BOOST_TEST( std::isnan(storage.min<&Particle::y>()) );
+    BOOST_TEST( std::isnan(storage.max<&Particle::y>()) );
+}
+
+BOOST_AUTO_TEST_CASE(group_by)
+{
+    struct Row {
+        int key;
+        int sum;
+        int count;
+        int max;
+    };
+
+    VECTOR_CONTAINER<A> storage;
+    for (int i = 0; i < 1000; ++i)
+        storage.push_back(A{i, (i * 7) % 5, 1});
+
+    const auto query = storage.group_by<&A::key>().sum<&A::val>().count().max<&A::val>();
+    for (size_t threads : { 1, 3 }) {
+        const auto result = query.collect<Row>(threads);
+        BOOST_TEST( result.size() == 5 );
+        BOOST_TEST( (result[0]->*(&Row::key)) == 0 );
+        BOOST_TEST( (result[1]->*(&Row::key)) == 2 );
+        BOOST_TEST( (result[1]->*(&Row::count)) == 200 );
+        BOOST_TEST( (result[1]->*(&Row::max)) == 996 );
+        BOOST_TEST( storage.sum<&A::val>() == result.sum<&Row::sum>() );
+    }
+}
+
+BOOST_AUTO_TEST_CASE(join_on_key)
+{
+    struct Meta {
+        int id;
+        int type;
+    };
+
+    VECTOR_CONTAINER<Meta> left;
+    left.push_back(Meta{1, 10});
+    left.push_back(Meta{2, 20});
+    left.push_back(Meta{1, 30});
+    left.push_back(Meta{4, 40});
+
+    VECTOR_CONTAINER<A> right(5);
+    for (int i = 0; i < 5; ++i)
+        right[i] = A{i, i * 100, 0};
+
+    std::vector<std::pair<int, int>> matches;
+    const auto count = aoaoaott::hash_join<&Meta::id, &A::val>(left, right, [&](auto l, auto r) {
+        matches.emplace_back(l->*(&Meta::type), r->*(&A::key));
+        r->*(&A::dum) += 1;
+    });
+
+    const std::vector<std::pair<int, int>> expected = { {10, 100}, {30, 100}, {20, 200}, {40, 400} };
+    BOOST_TEST( count == 4 );
+    BOOST_TEST( (matches == expected) );
+    BOOST_TEST( (right[1]->*(&A::dum)) == 2 );
+    BOOST_TEST( (right[3]->*(&A::dum)) == 0 );
+}
+
+BOOST_AUTO_TEST_CASE(hash_index)
+{
+    VECTOR_CONTAINER<A> storage;
+    for (int i = 0; i < 100; ++i)
+        storage.push_back(A{i, i * 3, 0});
+
+    HashIndex<&A::key> index(storage);
+    BOOST_TEST( index.size() == 100 );
+    BOOST_TEST( index.find(33) == 11 );
+    BOOST_TEST( index.find(34) == index.npos );
+
+    storage.push_back(A{100, 34, 0});
+    BOOST_TEST( index.insert(34, 100) );
+    BOOST_TEST( (storage[index.find(34)]->*(&A::val)) == 100 );
+
+    BOOST_TEST( !index.insert(33, 5) );
+    BOOST_TEST( index.find(33) == 5 );
+
+    BOOST_TEST( index.erase(0) );
+    BOOST_TEST( !index.erase(0) );
+    BOOST_TEST( !index.contains(0) );
+    BOOST_TEST( index.contains(3) );
+    BOOST_TEST( index.size() == 100 );
+}
+
+BOOST_AUTO_TEST_CASE(sorted_table)
+{
+    VECTOR_CONTAINER<A> storage;
+    for (int i = 0; i < 100; ++i)
+        storage.push_back(A{i, (i * 37) % 50, 0});
+
+    SortedSoATable<A, &A::key> table(storage);
+    BOOST_TEST( table.size() == 100 );
+    for (size_t i = 1; i < table.size(); ++i)
+        BOOST_TEST( (table[i - 1]->*(&A::key)) <= (table[i]->*(&A::key)) );
+
+    for (int key = -1; key <= 50; ++key) {
+        const size_t lower = std::min<size_t>(2 * std::max(key, 0), 100);
+        BOOST_TEST( table.lower_bound(key) == lower );
+        BOOST_TEST( table.upper_bound(key) == std::min<size_t>(2 * (key + 1), 100) );
+    }
+
+    const auto range = table.equal_range(37);
+    BOOST_TEST( (range.second - range.first) == 2 );
+    BOOST_TEST( range.first->get<&A::val>() == 1 );
+    BOOST_TEST( (range.first + 1)->get<&A::val>() == 51 );
+
+    const auto scan = table.range(10, 13);
+    BOOST_TEST( (scan.second - scan.first) == 6 );
+    BOOST_TEST( (table.range(13, 10).second == table.range(13, 10).first) );
+
+    SortedSoATable<A, &A::key> empty;
+    BOOST_TEST( empty.lower_bound(0) == 0 );
+}
+
+BOOST_AUTO_TEST_CASE(sorted_table_with_size_t_keys)
+{
+    struct Entry {
+        size_t id;
+        int64_t value;
+    };
+
+    VECTOR_CONTAINER<Entry> storage;
+    for (size_t i = 0; i < 10; ++i)
+        storage.push_back(Entry{ (i * 7) % 10, int64_t(i)});
+
+    SortedSoATable<Entry, &Entry::id> table(storage);
+    const auto range = table.equal_range(size_t{ 3});
+    BOOST_TEST( (range.second - range.first) == 1 );
+    BOOST_TEST( range.first->get<&Entry::value>() == 9 );
+
+    const auto scan = table.range(size_t{ 1}, size_t{ 5});
+    BOOST_TEST( (scan.second - scan.first) == 4 );
+    BOOST_TEST( (scan.first->get<&Entry::id>()) == 1 );
+}
+
+BOOST_AUTO_TEST_CASE(zone_map)
+{
+    VECTOR_CONTAINER<A> storage;
+    for (int i = 0; i < 1000; ++i)
+        storage.push_back(A{i, i / 10, 0});
+
+    ZoneMap<&A::val, &A::key> zones(storage, 64);
+    BOOST_TEST( (zones.find<&A::val>(storage, 500) - storage.begin()) == 500 );
+    BOOST_TEST( (zones.find<&A::key>(storage, 50) - storage.begin()) == 500 );
+    BOOST_TEST( (zones.find<&A::val>(storage, -1) == storage.end()) );
+
+    int visited = 0;
+    zones.scan<&A::val>(storage, 100, 199, [&](auto e) { ++visited; e->*(&A::dum) = 1; });
+    BOOST_TEST( visited == 100 );
+    BOOST_TEST( storage.sum<&A::dum>() == 100 );
+
+    // Stale blocks are not skipped even before refreshing
+    storage[5]->*(&A::val) = 5000;
+    zones.invalidate(5);
+    BOOST_TEST( (zones.find<&A::val>(storage, 5000) - storage.begin()) == 5 );
+    storage.push_back(A{-7, 0, 0});
+    BOOST_TEST( (zones.find<&A::val>(storage, -7) - storage.begin()) == 1000 );
+
+    zones.refresh(storage);
+    BOOST_TEST( (zones.find<&A::val>(storage, 5000) - storage.begin()) == 5 );
+    BOOST_TEST( (zones.find<&A::val>(storage, -7) - storage.begin()) == 1000 );
+    BOOST_TEST( (zones.find<&A::val>(storage, 5) == storage.end()) );
+}
+
+BOOST_AUTO_TEST_CASE(zone_map_bulk_writes)
+{
+    struct R {
+        int key;
+        int value;
+    };
+
+    // Only containers with the WriteLog policy log bulk writes, others keep their size
+    static_assert(sizeof(ARRAY_CONTAINER<R, 4>) == sizeof(R) * 4);
+    static_assert(!HasWriteLog<VECTOR_CONTAINER<R>>::value);
+
+    using Logged = VECTOR_CONTAINER<R, std::allocator, WriteLog>;
+    Logged storage(8192, R{ 0, 0});
+    ZoneMap<&R::key> zones(storage);
+
+    storage.assign(8192, R{ 100000, 1});
+    BOOST_TEST( (zones.find<&R::key>(storage, 100000) - storage.begin()) == 0 );
+    zones.refresh(storage);
+    BOOST_TEST( (zones.find<&R::key>(storage, 100000) - storage.begin()) == 0 );
+
+    Logged source;
+    for (int i = 0; i < 8192; ++i)
+        source.push_back(R{ i, i});
+    storage.assign(source);
+    zones.refresh(storage);
+    BOOST_TEST( (zones.find<&R::key>(storage, 4100) - storage.begin()) == 4100 );
+
+    storage.erase_if<&R::key>([](int key) { return key % 2 == 0; });
+    zones.refresh(storage);
+    BOOST_TEST( (zones.find<&R::key>(storage, 1809) - storage.begin()) == 904 );
+    BOOST_TEST( (zones.find<&R::key>(storage, 4100) == storage.end()) );
+
+    storage.col<&R::key>() = storage.col<&R::value>() * 0 - 5;
+    BOOST_TEST( (zones.find<&R::key>(storage, -5) - storage.begin()) == 0 );
+    zones.refresh(storage);
+    BOOST_TEST( (zones.find<&R::key>(storage, -5) - storage.begin()) == 0 );
+
+    storage = source;
+    BOOST_TEST( (zones.find<&R::key>(storage, 8000) - storage.begin()) == 8000 );
+    zones.refresh(storage);
+    BOOST_TEST( (zones.find<&R::key>(storage, 8000) - storage.begin()) == 8000 );
+}
+
+BOOST_AUTO_TEST_CASE(dirty_tracking)
+{
+    using Ranges = std::vector<std::pair<size_t, size_t>>;
+    auto dirty_ranges = [](const auto& storage) {
+        Ranges result;
+        storage.template for_each_dirty<&A::key>([&](size_t first, size_t last) { result.emplace_back(first, last); });
+        return result;
+    };
+
+    VECTOR_CONTAINER<A, std::allocator, DirtyTracking<16>> storage(100);
+    BOOST_TEST( (dirty_ranges(storage) == Ranges{ { 0, 100 } }) );
+    storage.clear_dirty();
+    BOOST_TEST( dirty_ranges(storage).empty() );
+
+    // Marking may allocate, so writes to tracked containers may throw
+    static_assert(!noexcept(storage[40]->*(&A::key) = 1));
+    static_assert(!noexcept(storage[50] = A{ 1, 2, 3 }));
+    static_assert(noexcept(std::declval<VECTOR_CONTAINER<A>&>()[40]->*(&A::key) = 1));
+
+    // Reads through const facades do not mark anything
+    const auto& cref = storage;
+    BOOST_TEST( (cref[40]->*(&A::key)) == 0 );
+    BOOST_TEST( storage.sum<&A::key>() == 0 );
+    BOOST_TEST( dirty_ranges(storage).empty() );
+
+    storage[40]->*(&A::key) = 1;
+    storage[47].get<&A::key>() = 2;
+    storage[99]->*(&A::val) = 3;
+    BOOST_TEST( (dirty_ranges(storage) == Ranges{ { 32, 48 } }) );
+
+    storage[50] = A{ 1, 2, 3 };
+    BOOST_TEST( (dirty_ranges(storage) == Ranges{ { 32, 64 } }) );
+
+    std::vector<std::tuple<size_t, size_t, size_t>> all;
+    storage.for_each_dirty([&](size_t column, size_t first, size_t last) { all.emplace_back(column, first, last); });
+    BOOST_TEST( (all == std::vector<std::tuple<size_t, size_t, size_t>>{ { 0, 48, 64 }, { 0, 96, 100 }, { 1, 32, 64 }, { 2, 48, 64 } }) );
+
+    storage.clear_dirty<&A::key>();
+    BOOST_TEST( dirty_ranges(storage).empty() );
+
+    VECTOR_CONTAINER<HasMethod, std::allocator, DirtyTracking<16>> methods(20, HasMethod{ 1, 2 });
+    methods.clear_dirty();
+    methods[3].method<&HasMethod::drink_double_bourbon>();
+    (methods[18]->*(&HasMethod::drink_double_bourbon))();
+    Ranges ranges;
+    methods.for_each_dirty<&HasMethod::delon>([&](size_t first, size_t last) { ranges.emplace_back(first, last); });
+    BOOST_TEST( (ranges == Ranges{ { 0, 20 } }) );
+
+    methods.push_back(HasMethod{ 1, 2 });
+    methods.clear_dirty();
+    methods.erase_if<&HasMethod::alain>([](int alain) { return alain > 1; });
+    ranges.clear();
+    methods.for_each_dirty<&HasMethod::alain>([&](size_t first, size_t last) { ranges.emplace_back(first, last); });
+    BOOST_TEST( (ranges == Ranges{ { 0, 19 } }) );
+}
+
+template<typename Vector>
+static void check_snapshot()
+{
+    Vector storage(1000, A{ 1, 2, 3 });
+    auto snapshot = storage.snapshot();
+    const auto& origin = storage;
+
+    // Columns are shared until written
+    BOOST_TEST( &((*snapshot)[500]->*(&A::key)) == &(origin[500]->*(&A::key)) );
+
+    storage[500]->*(&A::key) = 20;
+    storage[10] = A{ 4, 5, 6 };
+    storage.push_back(A{ 7, 8, 9 });
+    BOOST_TEST( (storage[500]->*(&A::key)) == 20 );
+    BOOST_TEST( ((*snapshot)[500]->*(&A::key)) == 2 );
+    BOOST_TEST( ((*snapshot)[10]->*(&A::val)) == 1 );
+    BOOST_TEST( snapshot->size() == 1000 );
+    BOOST_TEST( storage.size() == 1001 );
+    BOOST_TEST( snapshot->template sum<&A::key>() == 2000 );
+    BOOST_TEST( storage.template sum<&A::key>() == 2000 + 18 + 3 + 8 );
+
+    // Copies are detached independently
+    auto copy = storage;
+    copy[0].template get<&A::dum>() = 100;
+    BOOST_TEST( (storage[0]->*(&A::dum)) == 3 );
+    BOOST_TEST( copy.template erase_if<&A::val>([](int val) { return val == 4; }) == 1 );
+    BOOST_TEST( (storage[10]->*(&A::val)) == 4 );
+
+    // Column expressions and batches detach the columns they write
+    auto before = storage.snapshot();
+    storage.template col<&A::val>() = storage.template col<&A::key>() * 2;
+    storage.template batch<8>(0)->*(&A::dum) = Batch<int, 8>(-1);
+    BOOST_TEST( (storage[500]->*(&A::val)) == 40 );
+    BOOST_TEST( ((*before)[500]->*(&A::val)) == 1 );
+    BOOST_TEST( (storage[7]->*(&A::dum)) == -1 );
+    BOOST_TEST( ((*before)[7]->*(&A::dum)) == 3 );
+}
+
+BOOST_AUTO_TEST_CASE(cow_snapshot)
+{
+    check_snapshot<CowSoAVector<A>>();
+    check_snapshot<CowSoAVector<A, 64>>();
+
+    // A write to a shared column copies it, so it may throw
+    static_assert(!noexcept(std::declval<CowSoAVector<A>&>()[5]->*(&A::key) = 1));
+    static_assert(!noexcept(std::declval<CowSoAVector<A>&>()[5] = A{}));
+
+    // Blocks which are not written remain shared
+    CowSoAVector<A, 64> storage(1000);
+    auto snapshot = storage.snapshot();
+    storage[5]->*(&A::key) = 1;
+    const auto& origin = storage;
+    BOOST_TEST( &((*snapshot)[5]->*(&A::key)) != &(origin[5]->*(&A::key)) );
+    BOOST_TEST( &((*snapshot)[5]->*(&A::val)) == &(origin[5]->*(&A::val)) );
+    BOOST_TEST( &((*snapshot)[500]->*(&A::key)) == &(origin[500]->*(&A::key)) );
+}
+
+BOOST_AUTO_TEST_CASE(concurrent_push_back)
+{
+    using Vector = std::conditional_t<std::is_same_v<VECTOR_CONTAINER<A>, SoAVector<A>>, ConcurrentSoAVector<A, 64>, ConcurrentAoSVector<A, 64>>;
+    Vector storage;
+    const int producers = 4;
+    const int count = 10000;
+
+    std::vector<std::thread> threads;
+    for (int t = 0; t < producers; ++t)
+        threads.emplace_back([&storage, t] {
+            for (int i = 0; i < count; i += 2) {
+                storage.push_back(A{ i, t, 1 });
+                const A batch[] = { A{ i + 1, t, 1 } };
+                storage.push_back(std::begin(batch), std::end(batch));
+            }
+        });
+
+    // Published prefix is always filled
+    size_t checked = 0;
+    while (checked < size_t(producers * count)) {
+        const size_t s = storage.size();
+        if (s == checked)
+            std::this_thread::yield();
+        for (; checked < s; ++checked)
+            BOOST_REQUIRE( (std::as_const(storage)[checked]->*(&A::dum)) == 1 );
+    }
+
+    for (auto& thread : threads)
+        thread.join();
+
+    BOOST_TEST( storage.size() == size_t(producers * count) );
+    std::vector<int> next(producers, 0);
+    bool ordered = true;
+    storage.for_each([&](auto e) {
+        ordered &= (e->*(&A::val)) == next[e->*(&A::key)]++;
+    });
+    BOOST_TEST( ordered );
+    BOOST_TEST( (next == std::vector<int>(producers, count)) );
+
+    storage[7]->*(&A::dum) = 5;
+    BOOST_TEST( (storage[7]->*(&A::dum)) == 5 );
+}
+
+BOOST_AUTO_TEST_CASE(concurrent_overflow)
+{
+    using Vector = std::conditional_t<std::is_same_v<VECTOR_CONTAINER<A>, SoAVector<A>>, ConcurrentSoAVector<A, 4, 2>, ConcurrentAoSVector<A, 4, 2>>;
+    Vector storage;
+    const A batch[] = { A{ 1, 2, 3 }, A{ 4, 5, 6 }, A{ 7, 8, 9 } };
+    storage.push_back(std::begin(batch), std::end(batch));
+    storage.push_back(std::begin(batch), std::end(batch));
+
+    // A failed append reserves nothing, so the elements which fit are still appended
+    BOOST_CHECK_THROW( storage.push_back(std::begin(batch), std::end(batch)), std::length_error );
+    BOOST_TEST( storage.size() == 6u );
+    BOOST_TEST( storage.push_back(A{ 10, 11, 12 }) == 6u );
+    BOOST_TEST( storage.push_back(A{ 13, 14, 15 }) == 7u );
+    BOOST_CHECK_THROW( storage.push_back(A{ 16, 17, 18 }), std::length_error );
+    BOOST_TEST( storage.size() == 8u );
+    BOOST_TEST( (std::as_const(storage)[7]->*(&A::val)) == 13 );
+}
+
+BOOST_AUTO_TEST_CASE(segmented_vector)
+{
+    using Vector = std::conditional_t<std::is_same_v<VECTOR_CONTAINER<A>, SoAVector<A>>, SegmentedSoAVector<A, 16>, SegmentedAoSVector<A, 16>>;
+    Vector storage;
+    storage.push_back(A{ 0, 0, 0 });
+    const int* first = &(storage[0]->*(&A::key));
+
+    // Growth never moves elements
+    for (int i = 1; i < 100; ++i)
+        storage.push_back(A{ i, i % 7, 1 });
+    BOOST_TEST( first == &(storage[0]->*(&A::key)) );
+    BOOST_TEST( storage.size() == 100 );
+    BOOST_TEST( storage.capacity() >= 100 );
+
+    // Column algorithms cross chunk boundaries
+    BOOST_TEST( (storage.find<&A::val>(37) - storage.begin()) == 37 );
+    BOOST_TEST( (storage.find<&A::val>(100) == storage.end()) );
+    BOOST_TEST( storage.count<&A::key>(3) == 14 );
+    BOOST_TEST( storage.sum<&A::val>() == 4950 );
+    BOOST_TEST( storage.max<&A::val>() == 99 );
+    BOOST_TEST( storage.min<&A::dum>() == 0 );
+
+    int expected = 0;
+    bool ordered = true;
+    for (const auto& e : storage)
+        ordered &= (e->*(&A::val)) == expected++;
+    BOOST_TEST( ordered );
+
+    BOOST_TEST( storage.erase_if<&A::key>([](int key) { return key == 0; }) == 15 );
+    BOOST_TEST( storage.size() == 85 );
+    BOOST_TEST( (storage[0]->*(&A::val)) == 1 );
+    BOOST_TEST( (storage[84]->*(&A::val)) == 99 );
+
+    storage.resize(20);
+    storage.resize(40, A{ 5, 6, 7 });
+    BOOST_TEST( (storage[39]->*(&A::dum)) == 7 );
+    BOOST_TEST( storage.sum<&A::dum>() == 20 + 20 * 7 );
+    storage.shrink_to_fit();
+    BOOST_TEST( storage.capacity() == 48 );
+}
+
+BOOST_AUTO_TEST_CASE(small_vector)
+{
+    using Vector = std::conditional_t<std::is_same_v<VECTOR_CONTAINER<A>, SoAVector<A>>, SmallSoAVector<A, 8>, SmallAoSVector<A, 8>>;
+    Vector storage;
+    for (int i = 0; i < 8; ++i)
+        storage.push_back(A{ i, 2 * i, 1 });
+
+    // Elements are kept inside the object
+    auto inside = [&storage](size_t i) {
+        const auto* address = reinterpret_cast<const char*>(&(storage[i]->*(&A::key)));
+        const auto* object = reinterpret_cast<const char*>(&storage);
+        return address >= object && address < object + sizeof(storage);
+    };
+    BOOST_TEST( storage.capacity() == 8 );
+    BOOST_TEST( inside(7) );
+    BOOST_TEST( (storage.find<&A::key>(6) - storage.begin()) == 3 );
+
+    // ... and spilled to the heap beyond the inline capacity
+    storage.push_back(A{ 8, 16, 1 });
+    BOOST_TEST( !inside(0) );
+    BOOST_TEST( storage.size() == 9 );
+    BOOST_TEST( storage.sum<&A::key>() == 72 );
+    BOOST_TEST( (storage[8]->*(&A::key)) == 16 );
+
+    storage.erase_if<&A::val>([](int val) { return val % 2 == 0; });
+    storage.shrink_to_fit();
+    BOOST_TEST( storage.capacity() == 8 );
+    BOOST_TEST( inside(0) );
+    BOOST_TEST( storage.size() == 4 );
+    BOOST_TEST( (storage[3]->*(&A::val)) == 7 );
+
+    auto copy = storage;
+    Vector moved = std::move(storage);
+    BOOST_TEST( storage.empty() );
+    BOOST_TEST( moved.sum<&A::val>() == 16 );
+    BOOST_TEST( copy.sum<&A::val>() == 16 );
+
+    moved.resize(20, A{ 1, 1, 1 });
+    moved.resize(2);
+    BOOST_TEST( moved.sum<&A::val>() == 4 );
+}
+
+BOOST_AUTO_TEST_CASE(slot_map)
+{
+    using Map = std::conditional_t<std::is_same_v<VECTOR_CONTAINER<A>, SoAVector<A>>, SoASlotMap<A>, AoSSlotMap<A>>;
+    Map map;
+    std::vector<Map::Handle> handles;
+    for (int i = 0; i < 10; ++i)
+        handles.push_back(map.insert(A{ i, 10 * i, 0 }));
+
+    BOOST_TEST( map.erase(handles[2]) );
+    BOOST_TEST( !map.erase(handles[2]) );
+    BOOST_TEST( !map.contains(handles[2]) );
+    BOOST_TEST( map.size() == 9 );
+
+    // The last element has been moved to the hole, but its handle is still valid
+    BOOST_TEST( map.index_of(handles[9]) == 2 );
+    BOOST_TEST( (map[handles[9]]->*(&A::key)) == 90 );
+    BOOST_TEST( (map.handle(2) == handles[9]) );
+    map[handles[5]]->*(&A::dum) = 7;
+    BOOST_TEST( (std::as_const(map).at(handles[5])->*(&A::dum)) == 7 );
+    BOOST_CHECK_THROW( map.at(handles[2]), std::out_of_range );
+
+    // Slots are reused with new generations
+    auto reused = map.insert(A{ 100, 1000, 0 });
+    BOOST_TEST( reused.slot == handles[2].slot );
+    BOOST_TEST( (reused != handles[2]) );
+    BOOST_TEST( !map.contains(handles[2]) );
+    BOOST_TEST( (map[reused]->*(&A::val)) == 100 );
+
+    int sum = 0;
+    for (const auto& e : map)
+        sum += e->*(&A::val);
+    BOOST_TEST( sum == 45 - 2 + 100 );
+    BOOST_TEST( map.dense().sum<&A::val>() == 45 - 2 + 100 );
+
+    for (int i = 0; i < 10; ++i)
+        if (i != 2)
+            BOOST_TEST( (map[handles[i]]->*(&A::val)) == i );
+
+    map.clear();
+    BOOST_TEST( map.empty() );
+    BOOST_TEST( !map.contains(reused) );
+}
+
+BOOST_AUTO_TEST_CASE(ring_buffer)
+{
+    auto ring = std::make_unique<SoARingBuffer<A, 8>>();
+    BOOST_TEST( ring->push(A{ 0, 0, 0 }) );
+    const std::vector<A> batch = { A{ 1, 10, 0 }, A{ 2, 20, 0 }, A{ 3, 30, 0 }, A{ 4, 40, 0 }, A{ 5, 50, 0 }, A{ 6, 60, 0 }, A{ 7, 70, 0 }, A{ 8, 80, 0 } };
+    BOOST_TEST( ring->push(batch.begin(), batch.end()) == 7 );
+    BOOST_TEST( !ring->push(A{ 9, 90, 0 }) );
+    BOOST_TEST( ring->size() == 8 );
+
+    A value{};
+    BOOST_TEST( ring->pop(value) );
+    BOOST_TEST( value.val == 0 );
+    std::vector<A> popped;
+    BOOST_TEST( ring->pop(std::back_inserter(popped), 3) == 3 );
+    BOOST_TEST( popped.back().key == 30 );
+
+    // Wrapped elements are split into two views
+    BOOST_TEST( ring->push(batch.begin(), batch.begin() + 3) == 3 );
+    auto view = ring->peek();
+    BOOST_TEST( view.size() == 4 );
+    BOOST_TEST( (view.column<&A::key>()[0]) == 40 );
+    BOOST_TEST( (view[3]->*(&A::val)) == 7 );
+    BOOST_TEST( std::accumulate(view.column<&A::key>().begin(), view.column<&A::key>().end(), 0) == 220 );
+    ring->consume(view.size());
+    view = ring->peek();
+    BOOST_TEST( view.size() == 3 );
+    BOOST_TEST( (view.column<&A::val>()[2]) == 3 );
+    ring->consume(3);
+    BOOST_TEST( ring->empty() );
+}
+
+template<typename Producers>
+static void check_ring_buffer_threads(int producers)
+{
+    const int count = 20000;
+    auto ring = std::make_unique<SoARingBuffer<A, 64, Producers>>();
+    std::vector<std::thread> threads;
+    for (int t = 0; t < producers; ++t)
+        threads.emplace_back([&ring, t] {
+            for (int i = 0; i < count;) {
+                const A batch[] = { A{ i, t, 0 }, A{ i + 1, t, 0 }, A{ i + 2, t, 0 }, A{ i + 3, t, 0 } };
+                const size_t pushed = ring->push(std::begin(batch), std::end(batch));
+                if (pushed == 0)
+                    std::this_thread::yield();
+                i += int(pushed);
+            }
+        });
+
+    std::vector<int> next(producers, 0);
+    bool ordered = true;
+    for (int received = 0; received < producers * count;) {
+        auto view = ring->peek();
+        if (view.empty())
+            std::this_thread::yield();
+        for (size_t i = 0; i < view.size(); ++i)
+            ordered &= view.template column<&A::val>()[i] == next[view.template column<&A::key>()[i]]++;
+        ring->consume(view.size());
+        received += int(view.size());
+    }
+
+    for (auto& thread : threads)
+        thread.join();
+    BOOST_TEST( ordered );
+    BOOST_TEST( ring->empty() );
+}
+
+BOOST_AUTO_TEST_CASE(ring_buffer_threads)
+{
+    check_ring_buffer_threads<SingleProducer>(1);
+    check_ring_buffer_threads<MultipleProducers>(4);
+}
+
+BOOST_AUTO_TEST_CASE(hash_map)
+{
+    using Map = std::conditional_t<std::is_same_v<VECTOR_CONTAINER<A>, SoAVector<A>>, SoAHashMap<int, A>, AoSHashMap<int, A>>;
+    Map map;
+    for (int i = 0; i < 1000; ++i)
+        BOOST_TEST( map.insert(i * 7, A{ i, i * 7, 0 }).second );
+    BOOST_TEST( !map.insert(14, A{}).second );
+    BOOST_TEST( map.size() == 1000 );
+
+    BOOST_TEST( (map[14]->*(&A::val)) == 2 );
+    map[21]->*(&A::dum) = 5;
+    BOOST_TEST( (std::as_const(map).at(21)->*(&A::dum)) == 5 );
+    BOOST_TEST( map.contains(6993) );
+    BOOST_TEST( !map.contains(6994) );
+    BOOST_TEST( !map.find(6994).has_value() );
+    BOOST_TEST( (*std::as_const(map).find(6993)->*(&A::val)) == 999 );
+    BOOST_CHECK_THROW( map.at(6994), std::out_of_range );
+
+    // Missing keys are inserted with value-initialized elements
+    BOOST_TEST( (map[-1]->*(&A::key)) == 0 );
+    BOOST_TEST( map.size() == 1001 );
+
+    for (int i = 0; i < 1000; i += 2)
+        BOOST_TEST( map.erase(i * 7) );
+    BOOST_TEST( !map.erase(0) );
+    BOOST_TEST( map.size() == 501 );
+
+    bool consistent = true;
+    int sum = 0;
+    map.for_each([&](int k, auto e) {
+        consistent &= k == -1 || k == (e->*(&A::key));
+        sum += e->*(&A::val);
+    });
+    BOOST_TEST( consistent );
+    BOOST_TEST( sum == 250000 );
+
+    // Erased slots are reused
+    for (int i = 0; i < 1000; i += 2)
+        map.insert(i * 7, A{ i, i * 7, 0 });
+    for (int i = 0; i < 1000; ++i)
+        BOOST_TEST( (map.at(i * 7)->*(&A::val)) == i );
+
+    map.clear();
+    BOOST_TEST( map.empty() );
+    BOOST_TEST( !map.contains(7) );
+}
+
+struct Inner {
+    int x;
+    int y;
+};
+
+struct Outer {
+    int id;
+    Inner inner;
+    A a;
+};
+
+BOOST_AUTO_TEST_CASE(nested_paths)
+{
+    VECTOR_CONTAINER<Outer> storage(10);
+    storage[3].get<&Outer::inner, &Inner::y>() = 7;
+    BOOST_TEST( (storage[3]->*(&Outer::inner)).y == 7 );
+    BOOST_TEST( (std::as_const(storage)[3].get<&Outer::inner, &Inner::y>()) == 7 );
+    BOOST_TEST( (storage.column<&Outer::inner, &Inner::y>()[3]) == 7 );
+}
+
+BOOST_AUTO_TEST_CASE(deep_layout)
+{
+    using Storage = std::conditional_t<std::is_same_v<VECTOR_CONTAINER<A>, SoAVector<A>>, DeepSoAVector<Outer>, AoSVector<Outer>>;
+    Storage storage;
+    for (int i = 0; i < 100; ++i)
+        storage.push_back(Outer{ i, Inner{ i * 2, i * 3 }, A{ i, -i, 0 } });
+
+    BOOST_TEST( (storage[10].get<&Outer::inner, &Inner::x>()) == 20 );
+    BOOST_TEST( (storage[10].get<&Outer::a, &A::key>()) == -10 );
+    storage[10].get<&Outer::a, &A::dum>() = 42;
+
+    // Nested structures are rebuilt by aggregation
+    const Outer value = storage[10];
+    BOOST_TEST( value.id == 10 );
+    BOOST_TEST( value.inner.y == 30 );
+    BOOST_TEST( value.a.dum == 42 );
+
+    storage[11] = Outer{ 5, Inner{ 6, 7 }, A{ 8, 9, 10 } };
+    BOOST_TEST( (storage[11].get<&Outer::inner, &Inner::y>()) == 7 );
+    BOOST_TEST( (storage[11].get<&Outer::a, &A::dum>()) == 10 );
+
+    const auto& column = storage.template column<&Outer::inner, &Inner::x>();
+    if constexpr (!std::is_same_v<Storage, AoSVector<Outer>>)
+        BOOST_TEST( (bold_cast(column[1]) - bold_cast(column[0])) == sizeof(int) );
+    BOOST_TEST( column[99] == 198 );
+}
+
+struct Keyed {
+    int id;
+    std::array<char, 8> key;
+};
+
+BOOST_AUTO_TEST_CASE(transposed_arrays)
+{
+    using Storage = std::conditional_t<std::is_same_v<VECTOR_CONTAINER<A>, SoAVector<A>>, TransposedSoAVector<Keyed>, AoSVector<Keyed>>;
+    Storage storage;
+    for (int i = 0; i < 100; ++i)
+        storage.push_back(Keyed{ i, { char('a' + i % 26), char('a' + i % 3), 'x' } });
+
+    // The same source works for arrays and proxies
+    auto&& key = storage[30]->*(&Keyed::key);
+    BOOST_TEST( key[0] == 'e' );
+    BOOST_TEST( key[1] == 'a' );
+    key[2] = 'y';
+    BOOST_TEST( (std::as_const(storage)[30]->*(&Keyed::key))[2] == 'y' );
+    BOOST_TEST( (storage[31].get<&Keyed::key>()[2]) == 'x' );
+
+    storage[5] = Keyed{ 5, { 'q', 'r' } };
+    const Keyed value = storage[5];
+    BOOST_TEST( value.key[0] == 'q' );
+    BOOST_TEST( value.key[1] == 'r' );
+    BOOST_TEST( value.key[2] == 0 );
+
+    // Prefix filtering scans only the first elements of keys
+    const auto& first = storage.template column<&Keyed::key>(0);
+    size_t matches = 0;
+    for (size_t i = 0; i < storage.size(); ++i)
+        matches += first[i] == 'a';
+    BOOST_TEST( matches == 4 );
+    if constexpr (!std::is_same_v<Storage, AoSVector<Keyed>>)
+        BOOST_TEST( (bold_cast(first[1]) - bold_cast(first[0])) == 1 );
+
+    storage.template erase_if<&Keyed::id>([](int id) { return id % 2 == 0; });
+    BOOST_TEST( storage.size() == 50 );
+    BOOST_TEST( (storage[15]->*(&Keyed::key))[0] == 'f' );
+}
+
+enum class Kind : int32_t { read = -1000, write = 5, flush = 1 << 20 };
+
+struct Sample {
+    int64_t timestamp;
+    int64_t small;
+    Kind kind;
+    float weight;
+};
+
+BOOST_AUTO_TEST_CASE(frozen_columns)
+{
+    VECTOR_CONTAINER<Sample> storage;
+    const Kind kinds[] = { Kind::read, Kind::write, Kind::flush };
+    for (int i = 0; i < 1000; ++i)
+        storage.push_back(Sample{ 1'000'000'000'000 + i * 3 + i % 2, 100 + i % 50, kinds[i % 3], i * 0.5f });
+
+    const auto frozen = storage.freeze();
+    BOOST_TEST( frozen.size() == 1000 );
+    BOOST_TEST( (frozen.encoding<&Sample::timestamp>() == Encoding::delta) );
+    BOOST_TEST( (frozen.encoding<&Sample::small>() == Encoding::frame_of_reference) );
+    BOOST_TEST( (frozen.encoding<&Sample::kind>() == Encoding::dictionary) );
+    BOOST_TEST( (frozen.encoding<&Sample::weight>() == Encoding::plain) );
+    BOOST_TEST( frozen.memory_usage() < storage.size() * sizeof(Sample) / 2 );
+
+    bool same = true;
+    for (size_t i = 0; i < storage.size(); ++i) {
+        const Sample expected = storage[i];
+        const Sample actual = frozen[i];
+        same &= std::memcmp(&expected, &actual, sizeof(Sample)) == 0;
+    }
+    BOOST_TEST( same );
+    BOOST_TEST( frozen.get<&Sample::timestamp>(257) == 1'000'000'000'000 + 257 * 3 + 1 );
+
+    BOOST_TEST( frozen.count<&Sample::kind>(Kind::flush) == 333 );
+    BOOST_TEST( frozen.count<&Sample::small>(149) == 20 );
+    BOOST_TEST( frozen.count<&Sample::small>(150) == 0 );
+    BOOST_TEST( frozen.find<&Sample::small>(120) == 20 );
+    BOOST_TEST( frozen.find<&Sample::timestamp>(1'000'000'000'000 + 2998) == 999 );
+    BOOST_TEST( frozen.find<&Sample::timestamp>(1) == frozen.size() );
+    BOOST_TEST( frozen.sum<&Sample::small>() == storage.template sum<&Sample::small>() );
+    BOOST_TEST( frozen.sum<&Sample::timestamp>() == storage.template sum<&Sample::timestamp>() );
+    BOOST_TEST( frozen.max<&Sample::timestamp>() == 1'000'000'000'000 + 2998 );
+    BOOST_TEST( (frozen.min<&Sample::kind>() == Kind::read) );
+
+    // Explicit encodings
+    auto copy = frozen;
+    copy.encode<&Sample::small>(Encoding::dictionary);
+    copy.encode<&Sample::timestamp>(Encoding::frame_of_reference);
+    BOOST_TEST( copy.sum<&Sample::small>() == frozen.sum<&Sample::small>() );
+    BOOST_TEST( copy.get<&Sample::timestamp>(999) == frozen.get<&Sample::timestamp>(999) );
+    BOOST_TEST( copy.find<&Sample::small>(149) == 49 );
+    BOOST_TEST( copy.find<&Sample::small>(150) == copy.size() );
+    BOOST_TEST( copy.count<&Sample::small>(149) == 20 );
+    BOOST_TEST( copy.find<&Sample::timestamp>(1'000'000'000'000 + 2998) == 999 );
+    BOOST_TEST( copy.count<&Sample::timestamp>(1'000'000'000'000 + 2998) == 1 );
+    BOOST_CHECK_THROW( copy.encode<&Sample::small>(Encoding::delta), std::invalid_argument );
+}
+
+struct Packed {
+    uint64_t code;
+    uint64_t time;
+};
+
+BOOST_AUTO_TEST_CASE(frozen_columns_of_all_widths)
+{
+    for (unsigned width = 1; width <= 64; ++width) {
+        const uint64_t mask = width == 64 ? ~uint64_t{} : (uint64_t{1} << width) - 1;
+        VECTOR_CONTAINER<Packed> storage;
+        uint64_t time = 0;
+        for (uint64_t i = 0; i < 1000; ++i) {
+            const uint64_t code = i == 0 ? mask : i == 1 ? 0 : (i * 0x9E3779B97F4A7C15) & mask;
+            time += code >> (width > 50 ? width - 50 : 0);
+            storage.push_back(Packed{ code, time });
+        }
+
+        auto frozen = storage.freeze();
+        frozen.encode<&Packed::code>(Encoding::frame_of_reference);
+        frozen.encode<&Packed::time>(Encoding::delta);
+
+        bool same = true;
+        frozen.for_each_block<&Packed::code>([&](const uint64_t* data, size_t first, size_t size) {
+            for (size_t i = 0; i < size; ++i)
+                same &= data[i] == storage[first + i]->*(&Packed::code);
+        });
+        frozen.for_each_block<&Packed::time>([&](const uint64_t* data, size_t first, size_t size) {
+            for (size_t i = 0; i < size; ++i)
+                same &= data[i] == storage[first + i]->*(&Packed::time);
+        });
+        BOOST_TEST( same, "width " << width );
+        BOOST_TEST( frozen.sum<&Packed::code>() == storage.sum<&Packed::code>() );
+        BOOST_TEST( frozen.sum<&Packed::time>() == storage.sum<&Packed::time>() );
+        BOOST_TEST( frozen.count<&Packed::code>(mask) == storage.count<&Packed::code>(mask) );
+        const uint64_t later = storage[777]->*(&Packed::code);
+        BOOST_TEST( frozen.find<&Packed::code>(later) == size_t(storage.find<&Packed::code>(later) - storage.begin()) );
+        BOOST_TEST( frozen.find<&Packed::code>(mask) == 0u );
+    }
+}
+
+BOOST_AUTO_TEST_CASE(column_expressions)
+{
+    VECTOR_CONTAINER<A> storage(100);
+    for (int i = 0; i < 100; ++i)
+        storage[i] = A{ i, i % 7, 1 };
+
+    storage.col<&A::dum>() = storage.col<&A::val>() << storage.col<&A::dum>();
+    BOOST_TEST( (storage[10]->*(&A::dum)) == 20 );
+
+    storage.col<&A::dum>() += 3 * storage.col<&A::key>() - 1;
+    BOOST_TEST( (storage[10]->*(&A::dum)) == 28 );
+
+    storage.col<&A::dum>().masked(storage.col<&A::key>() == 0) = -storage.col<&A::val>();
+    BOOST_TEST( (storage[14]->*(&A::dum)) == -14 );
+    BOOST_TEST( (storage[15]->*(&A::dum)) == 32 );
+
+    storage.col<&A::key>() = where(storage.col<&A::val>() % 2 == 0, 1, storage.col<&A::key>());
+    BOOST_TEST( (storage[16]->*(&A::key)) == 1 );
+    BOOST_TEST( (storage[17]->*(&A::key)) == 3 );
+
+    // Reductions
+    const auto& view = std::as_const(storage);
+    BOOST_TEST( view.col<&A::val>().sum() == 4950 );
+    BOOST_TEST( (view.col<&A::val>() * view.col<&A::val>()).sum() == 328350 );
+    BOOST_TEST( (view.col<&A::val>() >= 90).count() == 10 );
+    BOOST_TEST( (view.col<&A::val>() - 50).min() == -50 );
+    BOOST_TEST( (view.col<&A::val>() - 50).max() == 49 );
+    BOOST_TEST( (view.col<&A::key>() >= 0).all() );
+    BOOST_TEST( !(view.col<&A::key>() > 0).all() );
+    BOOST_TEST( !(view.col<&A::val>() > 100).any() );
+
+    // Assignments mark the whole column as modified
+    using Tracked = std::conditional_t<std::is_same_v<VECTOR_CONTAINER<A>, SoAVector<A>>,
+                                       SoAVector<A, std::allocator, DirtyTracking<16>>,
+                                       AoSVector<A, std::allocator, DirtyTracking<16>>>;
+    Tracked tracked(64);
+    tracked.clear_dirty();
+    tracked.col<&A::key>() = tracked.col<&A::val>() + 1;
+    size_t dirty = 0;
+    tracked.for_each_dirty([&](size_t, size_t first, size_t last) { dirty += last - first; });
+    BOOST_TEST( dirty == 64 );
+    BOOST_TEST( (tracked[63]->*(&A::key)) == 1 );
+}
+
+BOOST_AUTO_TEST_CASE(batch_facade)
+{
+    VECTOR_CONTAINER<A> storage(100);
+    for (int i = 0; i < 100; ++i)
+        storage[i] = A{ i, i % 3, 0 };
+
+    for (auto b : storage.batches<8>())
+        b->*(&A::dum) = ((b->*(&A::val)) << 1) + (b->*(&A::key));
+    BOOST_TEST( (storage[10]->*(&A::dum)) == 21 );
+    BOOST_TEST( (storage[99]->*(&A::dum)) == 198 );
+
+    // The last batch is partial
+    auto tail = storage.batch<8>(96);
+    BOOST_TEST( tail.size() == 4 );
+    BOOST_TEST( tail.mask().count() == 4 );
+    Batch<int, 8> values = tail->*(&A::val);
+    BOOST_TEST( values[3] == 99 );
+    BOOST_TEST( values[4] == 0 );
+    tail->*(&A::key) = Batch<int, 8>(7);
+    BOOST_TEST( (storage[99]->*(&A::key)) == 7 );
+
+    // Batches past the end are empty
+    auto past = storage.batch<8>(104);
+    BOOST_TEST( past.size() == 0 );
+    BOOST_TEST( past.mask().count() == 0 );
+    past->*(&A::key) = Batch<int, 8>(9);
+    BOOST_TEST( (std::as_const(storage).batch<8>(104)->*(&A::key))[0] == 0 );
+
+    // Masked stores
+    auto b = storage.batch<4>(0);
+    b->*(&A::val) = where((b->*(&A::key)) == 0, Batch<int, 4>(-1), b->*(&A::val));
+    (b->*(&A::dum)).store_if((b->*(&A::val)) > 1, Batch<int, 4>(5));
+    BOOST_TEST( (storage[0]->*(&A::val)) == -1 );
+    BOOST_TEST( (storage[3]->*(&A::val)) == -1 );
+    BOOST_TEST( (storage[2]->*(&A::val)) == 2 );
+    BOOST_TEST( (storage[2]->*(&A::dum)) == 5 );
+    BOOST_TEST( (storage[1]->*(&A::dum)) == 3 );
+
+    int sum = 0;
+    for (auto c : std::as_const(storage).batches<16>())
+        sum += (c->*(&A::val)).sum();
+    BOOST_TEST( sum == 4950 - 1 - 4 );
+}
+
+BOOST_AUTO_TEST_CASE(prefetching)
+{
+    VECTOR_CONTAINER<A> storage(100);
+    for (int i = 0; i < 100; ++i)
+        storage[i] = A{ i, i % 3, 0 };
+
+    // Hints have no observable effect
+    storage.prefetch<&A::val, &A::key>(5);
+    storage.prefetch<>(99, Locality::none);
+    std::as_const(storage).prefetch<&A::dum>(0, Locality::low);
+
+    int expected = 0;
+    for (auto e : storage.prefetching<&A::val>(8)) {
+        BOOST_TEST( (e->*(&A::val)) == expected++ );
+        e->*(&A::dum) = e->*(&A::val) * 2;
+    }
+    BOOST_TEST( expected == 100 );
+    BOOST_TEST( (storage[42]->*(&A::dum)) == 84 );
+
+    // The distance may be longer than the container
+    size_t count = 0;
+    for (auto e : std::as_const(storage).prefetching<>(1000, Locality::moderate))
+        count += (e->*(&A::key)) == 1;
+    BOOST_TEST( count == 33 );
+
+    std::vector<uint32_t> indices = { 97, 3, 50, 3 };
+    int sum = 0;
+    for (auto e : storage.prefetching_at<&A::val, &A::dum>(indices, 2))
+        sum += e->*(&A::val);
+    BOOST_TEST( sum == 97 + 3 + 50 + 3 );
+
+    for (auto e : storage.prefetching_at<&A::key>(indices))
+        e->*(&A::key) = -1;
+    BOOST_TEST( (storage[50]->*(&A::key)) == -1 );
+    BOOST_TEST( (storage[51]->*(&A::key)) == 0 );
+
+    DeepSoAVector<Outer> deep(4);
+    deep.prefetch<&Outer::inner>(1);
+    deep.prefetch<>(3);
+    TransposedSoAVector<Keyed> transposed(4);
+    transposed.prefetch<&Keyed::key>(2);
+    count = 0;
+    for (auto e : transposed.prefetching<&Keyed::key>(2))
+        count += (e->*(&Keyed::key))[0] == 0;
+    BOOST_TEST( count == 4 );
+}
+
+struct Named {
+    std::string name;
+    int id;
+    int flags;
+};
+
+BOOST_AUTO_TEST_CASE(streaming_writes)
+{
+    // Any bulk write of more than a few vectors uses non-temporal stores
+    const size_t threshold = streaming_threshold.exchange(64);
+
+    VECTOR_CONTAINER<A> storage(1000, A{1, 2, 3});
+    BOOST_TEST( (storage[999]->*(&A::dum)) == 3 );
+
+    // Unaligned start and a tail shorter than a group
+    storage.resize(1003, A{4, 5, 6});
+    BOOST_TEST( (storage[999]->*(&A::dum)) == 3 );
+    BOOST_TEST( (storage[1000]->*(&A::val)) == 4 );
+    BOOST_TEST( (storage[1002]->*(&A::dum)) == 6 );
+
+    storage.assign(777, A{7, 8, 9});
+    BOOST_TEST( storage.size() == 777 );
+    BOOST_TEST( (storage[0]->*(&A::val)) == 7 );
+    BOOST_TEST( (storage[776]->*(&A::key)) == 8 );
+
+    storage.assign(900, A{1, 1, 1});
+    BOOST_TEST( (storage[500]->*(&A::key)) == 1 );
+    BOOST_TEST( (storage[899]->*(&A::dum)) == 1 );
+
+    for (int i = 0; i < 900; ++i)
+        storage[i] = A{i, -i, 2 * i};
+
+    using Other = std::conditional_t<std::is_same_v<VECTOR_CONTAINER<A>, SoAVector<A>>, AoSVector<A>, SoAVector<A>>;
+    Other converted;
+    converted.assign(storage);
+    BOOST_TEST( converted.size() == 900 );
+    BOOST_TEST( (converted[0]->*(&A::val)) == 0 );
+    BOOST_TEST( (converted[899]->*(&A::key)) == -899 );
+    BOOST_TEST( (converted[457]->*(&A::dum)) == 914 );
+
+    VECTOR_CONTAINER<A> copy;
+    copy.assign(converted);
+    BOOST_TEST( (copy[300]->*(&A::dum)) == 600 );
+
+    std::vector<Outer> source(300, Outer{ 1, { 2, 3 }, { 4, 5, 6 } });
+    source[299].inner.y = 42;
+    DeepSoAVector<Outer> deep;
+    deep.assign(source);
+    BOOST_TEST( (deep[299].get<&Outer::inner, &Inner::y>()) == 42 );
+    BOOST_TEST( (deep[0].get<&Outer::a, &A::dum>()) == 6 );
+
+    // Types which are not trivially copyable are assigned element by element
+    const std::string text(100, 'x');
+    VECTOR_CONTAINER<Named> named(300, Named{ text, 1, 0 });
+    named.resize(400, Named{ text + "y", 2, 0 });
+    BOOST_TEST( (named[299]->*(&Named::name)) == text );
+    BOOST_TEST( (named[399]->*(&Named::name)) == text + "y" );
+    named.assign(500, Named{ "z", 3, 0 });
+    BOOST_TEST( (named[499]->*(&Named::name)) == "z" );
+    named.assign(std::vector<Named>(350, Named{ text, 4, 0 }));
+    BOOST_TEST( named.size() == 350 );
+    BOOST_TEST( (named[349]->*(&Named::name)) == text );
+    BOOST_TEST( (named[349]->*(&Named::id)) == 4 );
+
+    streaming_threshold = threshold;
+}
+
+BOOST_AUTO_TEST_CASE(grid_2d)
+{
+    constexpr bool is_soa = std::is_same_v<VECTOR_CONTAINER<A>, SoAVector<A>>;
+    std::conditional_t<is_soa, SoAGrid2D<A>, AoSGrid2D<A>> grid(13, 21, A{ 1, 2, 3 });
+    std::conditional_t<is_soa, TiledSoAGrid2D<A, 4>, TiledAoSGrid2D<A, 4>> tiled(13, 21, A{ 1, 2, 3 });
+    BOOST_TEST( tiled.width() == 13 );
+    BOOST_TEST( tiled.height() == 21 );
+    BOOST_TEST( tiled.cells().size() == 16 * 24 );
+    BOOST_TEST( (tiled(12, 20)->*(&A::dum)) == 3 );
+
+    for (size_t y = 0; y < 21; ++y)
+        for (size_t x = 0; x < 13; ++x) {
+            grid(x, y)->*(&A::val) = int(y * 100 + x);
+            tiled(x, y)->*(&A::val) = int(y * 100 + x);
+        }
+    BOOST_TEST( (grid(5, 7)->*(&A::val)) == 705 );
+    BOOST_TEST( (tiled(5, 7)->*(&A::val)) == 705 );
+    BOOST_TEST( (std::as_const(tiled).at(12, 20)->*(&A::val)) == 2012 );
+    BOOST_CHECK_THROW( tiled.at(13, 0), std::out_of_range );
+    BOOST_TEST( grid.index_of(5, 7) == 7 * 13 + 5 );
+
+    // Cells of a tile are consecutive, and tiles follow the Z-order curve
+    BOOST_TEST( tiled.index_of(1, 0) == 1 );
+    BOOST_TEST( tiled.index_of(0, 1) == 4 );
+    BOOST_TEST( tiled.index_of(4, 0) == 16 );
+    BOOST_TEST( tiled.index_of(0, 4) == 32 );
+    BOOST_TEST( tiled.index_of(4, 4) == 48 );
+
+    // Tiles cover each cell once
+    std::vector<int> covered(13 * 21);
+    size_t previous = 0;
+    tiled.for_each_tile([&](size_t x0, size_t y0, size_t x1, size_t y1) {
+        BOOST_TEST( tiled.index_of(x0, y0) >= previous );
+        previous = tiled.index_of(x0, y0);
+        for (size_t y = y0; y < y1; ++y)
+            for (size_t x = x0; x < x1; ++x)
+                ++covered[y * 13 + x];
+    });
+    BOOST_TEST( std::count(covered.begin(), covered.end(), 1) == 13 * 21 );
+
+    size_t tiles = 0;
+    grid.for_each_tile([&](size_t x0, size_t y0, size_t x1, size_t y1) { tiles += (x0 == 0 && y0 == 0 && x1 == 13 && y1 == 21); });
+    BOOST_TEST( tiles == 1 );
+}
+
+BOOST_AUTO_TEST_CASE(arrow_interop)
+{
+    auto storage = std::make_shared<SoAVector<A>>(10);
+    for (int i = 0; i < 10; ++i)
+        (*storage)[i] = A{ i, 10 * i, -i };
+    std::weak_ptr<SoAVector<A>> alive = storage;
+
+    ArrowSchema schema;
+    ArrowArray array;
+    export_arrow_schema<SoAVector<A>>(&schema, { "val", "key" });
+    export_arrow_array<SoAVector<A>>(storage, &array);
+    BOOST_TEST( std::string(schema.format) == "+s" );
+    BOOST_TEST( schema.n_children == 3 );
+    BOOST_TEST( std::string(schema.children[1]->name) == "key" );
+    BOOST_TEST( std::string(schema.children[2]->name) == "f2" );
+    BOOST_TEST( std::string(schema.children[2]->format) == "i" );
+    BOOST_TEST( array.length == 10 );
+    BOOST_TEST( array.children[1]->buffers[1] == storage->column<&A::key>().data() );
+
+    // The array pins the container
+    storage.reset();
+    BOOST_TEST( !alive.expired() );
+
+    // Slices are imported by offsets
+    array.offset = 2;
+    array.length = 5;
+    ArrowSoAView<A> view(&array, &schema);
+    BOOST_TEST( array.release == nullptr );
+    BOOST_TEST( view.size() == 5 );
+    BOOST_TEST( (view[0]->*(&A::key)) == 20 );
+    BOOST_TEST( view.sum<&A::val>() == 2 + 3 + 4 + 5 + 6 );
+    BOOST_TEST( ((*view.find<&A::dum>(-5))->*(&A::val)) == 5 );
+    BOOST_TEST( view[4].aggregate().dum == -6 );
+
+    auto copy = view;
+    view = ArrowSoAView<A>();
+    BOOST_TEST( !alive.expired() );
+    copy = ArrowSoAView<A>();
+    BOOST_TEST( alive.expired() );
+    schema.release(&schema);
+
+    // Fixed-size lists and nested structs
+    SoAVector<Keyed> keyed(3);
+    keyed[1] = Keyed{ 7, { 'a', 'b' } };
+    export_arrow(std::move(keyed), &schema, &array);
+    BOOST_TEST( std::string(schema.children[1]->format) == "+w:8" );
+    BOOST_TEST( std::string(schema.children[1]->children[0]->format) == "c" );
+    BOOST_CHECK_THROW( (ArrowSoAView<A>(&array, &schema)), std::invalid_argument );
+    BOOST_TEST( array.release != nullptr );
+    ArrowSoAView<Keyed> keys(&array, &schema);
+    BOOST_TEST( (keys[1]->*(&Keyed::key))[1] == 'b' );
+    schema.release(&schema);
+
+    DeepSoAVector<Outer> deep(4);
+    deep[3].get<&Outer::inner, &Inner::y>() = 11;
+    export_arrow(deep, &schema, &array, { "id", "inner", "a" });
+    BOOST_TEST( std::string(schema.children[1]->format) == "+s" );
+    BOOST_TEST( schema.children[2]->n_children == 3 );
+
+    // Children may be moved out and released on their own
+    ArrowArray inner = *array.children[1];
+    array.children[1]->release = nullptr;
+    array.release(&array);
+    BOOST_TEST( static_cast<const int*>(inner.children[1]->buffers[1])[3] == 11 );
+    inner.release(&inner);
+
+    // Nulls are not supported
+    ArrowSchema nested;
+    export_arrow(deep, &nested, &array);
+    const int dummy = 0;
+    array.children[0]->null_count = 1;
+    array.children[0]->buffers[0] = &dummy;
+    BOOST_CHECK_THROW( (ArrowSoAView<Outer, DeepLayout>(&array, &nested)), std::invalid_argument );
+    array.children[0]->null_count = 0;
+    array.children[0]->buffers[0] = nullptr;
+    ArrowSoAView<Outer, DeepLayout> outer(&array, &nested);
+    BOOST_TEST( (outer[3].get<&Outer::inner, &Inner::y>()) == 11 );
+    nested.release(&nested);
+    schema.release(&schema);
+}
+
+BOOST_AUTO_TEST_CASE(constexpr_array)
+{
+    struct Entry {
+        int square;
+        float root;
+    };
+
+    constexpr auto table = []() {
+        ARRAY_CONTAINER<Entry, 16> result;
+        for (size_t i = 0; i < result.size(); ++i) {
+            result[i]->*(&Entry::square) = int(i * i);
+            result[i].get<&Entry::root>() = i == 4 ? 2.f : 0.f;
+        }
+        result[15] = Entry{ -1, -1.f};
+        return result;
+    }();
+
+    static_assert((table[3]->*(&Entry::square)) == 9);
+    static_assert(table[4].get<&Entry::root>() == 2.f);
+    static_assert(Entry(table.at(15)).square == -1);
+
+    volatile size_t index = 7;
+    BOOST_TEST( (table[index]->*(&Entry::square)) == 49 );
+    BOOST_TEST( table.sum<&Entry::square>() == 1014 );
+}
+
+BOOST_AUTO_TEST_CASE(wide_sums)
+{
+    struct Sample {
+        int32_t count;
+        float weight;
+        uint16_t code;
+        uint16_t flags;
+    };
+
+    VECTOR_CONTAINER<Sample> storage(1001, Sample{ std::numeric_limits<int32_t>::max(), 16777216.f, 65535, 0});
+    storage[1000] = Sample{ -7, 1.f, 1, 0};
+
+    static_assert(std::is_same_v<decltype(storage.sum<&Sample::count>()), int64_t>);
+    static_assert(std::is_same_v<decltype(storage.sum<&Sample::weight>()), double>);
+    static_assert(std::is_same_v<decltype(storage.sum<&Sample::code>()), uint64_t>);
+    BOOST_TEST( storage.sum<&Sample::count>() == int64_t{ 1000} * std::numeric_limits<int32_t>::max() - 7 );
+    BOOST_TEST( storage.sum<&Sample::weight>() == 1000 * 16777216.0 + 1 );
+    BOOST_TEST( storage.sum<&Sample::code>() == 1000 * 65535 + 1 );
+    BOOST_TEST( (storage.col<&Sample::code>() + storage.col<&Sample::code>()).sum() == 2 * (1000 * 65535 + 1) );
 }
 
 BOOST_AUTO_TEST_CASE(vector_capacity)